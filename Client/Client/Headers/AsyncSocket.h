@@ -0,0 +1,56 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "Task.h"
+#include "WNetwork.h"
+
+#include <coroutine>
+#include <deque>
+#include <string>
+
+/*
+	Non-blocking view of an already connected socket. send/receive transfer the whole
+	buffer, suspending the calling coroutine on the event loop whenever the socket would block.
+	Concurrent sends take turns, so a buffer is never interleaved with another one.
+*/
+class AsyncSocket
+{
+	public:
+		class SendTurn
+		{
+			public:
+				SendTurn(AsyncSocket& socket) :
+					socket{ socket }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return !socket.sending; }
+				void await_suspend(std::coroutine_handle<> coroutine) { socket.sendQueue.emplace_back(coroutine); }
+				void await_resume() const noexcept { }
+			private:
+				AsyncSocket& socket;
+		};
+
+		AsyncSocket(EventLoop& loop, SocketHandle handle);
+
+		Task send(const void* data, int size);
+		Task receive(void* data, int size);
+
+		Task sendString(const std::string& text);
+		Task receiveString(std::string& text);
+
+		// fails pending and future operations; safe to call more than once
+		void close();
+
+		inline SocketHandle getHandle() const { return handle; }
+		inline EventLoop& getLoop() { return loop; }
+	private:
+		void finishSend();
+
+		EventLoop& loop;
+		SocketHandle handle;
+		bool closed;
+		bool sending;
+		std::deque<std::coroutine_handle<>> sendQueue;
+};
\ No newline at end of file
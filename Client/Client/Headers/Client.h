@@ -1,13 +1,17 @@
 #pragma once
 
+#include "AsyncSocket.h"
+#include "ConsoleInput.h"
+#include "EventLoop.h"
+#include "Protocol.h"
+#include "Task.h"
+#include "TimerWheel.h"
 #include "WNetwork.h"
 
+#include <deque>
 #include <memory>
 #include <string>
-#include <thread>
 #include <vector>
-#include <condition_variable>
-#include <mutex>
 
 class Interface;
 
@@ -16,6 +20,22 @@ class Client
 	using Score = int;
 
 	public:
+		/*
+			Where the client is in a round. The server's messages move it forward, the player's
+			input only ever answers the phase it is in; input typed ahead of its phase waits
+			in a queue, and a phase the server closed without us is simply left behind.
+		*/
+		enum class Phase
+		{
+			WaitingForRound,
+			ChoosingCards,
+			WaitingForChoices,
+			Judging,
+			WaitingForVerdict,
+			Confirming,
+			WaitingForConfirmation
+		};
+
 		Client(Interface& userInterface);
 		~Client();
 
@@ -27,37 +47,51 @@ class Client
 		void receiveNumOfRounds();
 		void receiveNumOfAnswers();
 		void start();
+		void spectate();
 	private:
 		void loadSettings();
 		
 		void receivePlayerID();
-		void receiveTsarIndex();
-		void receivePrompt();
-		void receiveStatementCards();
-		void receiveStatementCardChoices();
-		void receiveTsarChoice();
-		void receiveServerConfirmation();
-
-		void sendChoice(const std::string& choice);
-		void sendTsarChoice(const std::string& choice);
-
-		void send();
-		void receive();
-
-		void sendChoice_();
-		void sendTsarChoice_();
-		void sendConfirmation_();
-		void resetData_();
-
-		void receiveData_(int i);
-		void receiveStatementCardChoices_();
-		void receiveTsarChoice_();
-		void receiveConfirmation_();
+		Task receiveTsarIndex();
+		Task receivePrompt();
+		Task receiveStatementCards();
+		Task receiveStatementCardChoices();
+		Task receiveTsarChoice();
+		Task receiveServerConfirmation();
+
+		void sendChoice();
+		void sendTsarChoice(int choiceIndex);
+		void sendConfirmation();
+		Task submit(MessageType type, int round, MessageWriter writer);
+		Task sendMessage(MessageType type, int round, const MessageWriter& writer);
+		Task sendHeartbeat();
+
+		Task play();
+		Task watchTable();
+		Task resumeSession();
+		void sendResumeRequest();
+		Task receiveSnapshot();
+
+		Task receiveData_(int i);
+		Task receiveStatementCardChoices_();
+		Task receiveTsarChoice_();
+		Task receiveConfirmation_();
+
+		void enterPhase(Phase phase);
+		bool acceptsInput() const;
+		bool canConfirmEarly() const;
+		void onInput(const std::string& input);
+		void handleInput(const std::string& input);
+		void chooseStatementCard(const std::string& input);
+		void chooseWinner(const std::string& input);
+		int parseChoice(const std::string& input, int numOfOptions, const std::string& hint);
+		void showPrompt();
 
 		void displayInformation(int round);
 		void displayChoices();
 		void displayTsarChoice();
-		void confirmNextRound();
+		static std::string joinChoice(const std::vector<std::string>& choice);
+		void displayTable(const Message& frame);
 		void resetData();
 
 		std::shared_ptr<WSAManager> wsaManager;
@@ -68,15 +102,26 @@ class Client
 		const std::string settingsFilepath;
 
 		Socket socket;
+		EventLoop loop;
+		std::unique_ptr<AsyncSocket> connection;
+		ConsoleInput input;
+		Timer heartbeat;
 
 		Interface& userInterface;
 
 		int playerID;
+		// watching the table without a seat
+		bool spectating;
+		SessionToken sessionToken;
 		int numOfRounds;
+		int currentRound;
 		std::vector<std::pair<Score, std::string>> playerList;
 
-		std::thread sendThread;
-		std::thread receiveThread;
+		Phase phase;
+		std::deque<std::string> pendingInputs;
+		std::vector<int> selectedStatementCards;
+		// sent ahead of the verdict when the player had nothing left to answer this round
+		bool confirmationSent;
 
 		int tsarIndex;
 		int promptNumOfBlanks;
@@ -85,36 +130,6 @@ class Client
 		std::vector<std::vector<std::string>> statementCardChoices;
 		std::string prompt;
 		std::vector<std::string> statementCards;
-
-		bool doneReceivingData;
-		std::condition_variable dataReceived;
-		std::mutex dataReceivedMutex;
-
-		bool sentChoice;
-		std::condition_variable choiceSent;
-		std::mutex choiceSentMutex;
-
-		bool receivedChoices;
-		std::condition_variable choicesReceived;
-		std::mutex choicesReceivedMutex;
-
-		bool m_sentTsarChoice;
-		std::condition_variable m_tsarChoiceSent;
-		std::mutex m_tsarChoiceSentMutex;
-
-		bool receivedTsarChoice;
-		std::condition_variable tsarChoiceReceived;
-		std::mutex tsarChoiceReceivedMutex;
-
-		bool sentConfirmation;
-		std::condition_variable confirmationSent;
-		std::mutex confirmationSentMutex;
-
-		bool receivedConfirmation;
-		std::condition_variable confirmationReceived;
-		std::mutex confirmationReceivedMutex;
-
-		bool flagsReset;
-		std::condition_variable resetFlags;
-		std::mutex resetFlagsMutex;
+		// what the server knows the cards of the hand by
+		std::vector<int> statementCardIds;
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "Screen.h"
+#include "TimerWheel.h"
+
+#include <functional>
+#include <string>
+
+namespace console
+{
+	// how often typed keys are picked up; well below what a player can notice
+	const int POLL_INTERVAL_MILLISECONDS = 15;
+}
+
+/*
+	Console input read on the event loop's own thread. The console can't be waited on together
+	with sockets, so a timer drains whatever was typed since it last looked, echoes it on the
+	screen, and hands every finished word to the handler. Nothing blocks on the console, a message from the
+	server is handled the moment it arrives even while the player is typing.
+*/
+class ConsoleInput
+{
+	using InputHandler = std::function<void(const std::string&)>;
+
+	public:
+		ConsoleInput(EventLoop& loop, Screen& screen);
+
+		ConsoleInput(const ConsoleInput&) = delete;
+		ConsoleInput& operator=(const ConsoleInput&) = delete;
+
+		void start(const InputHandler& handler);
+		void stop();
+	private:
+		void poll();
+		void finishLine();
+
+		EventLoop& loop;
+		Screen& screen;
+		Timer pollTimer;
+		InputHandler handler;
+		bool running;
+		std::string line;
+};
\ No newline at end of file
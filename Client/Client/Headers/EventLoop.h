@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Task.h"
+#include "TimerWheel.h"
+#include "WNetwork.h"
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/*
+	Single-threaded event loop. Coroutines suspend on socket readiness, timers or phase events
+	and are resumed from here; WSAPoll multiplexes every waiting socket at once and its timeout
+	is driven by the timer wheel. post() is the only member that may be called from other threads.
+*/
+class EventLoop
+{
+	public:
+		class IoAwaiter
+		{
+			public:
+				IoAwaiter(EventLoop& loop, SocketHandle handle, bool write) :
+					loop{ loop },
+					handle{ handle },
+					write{ write }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return false; }
+				void await_suspend(std::coroutine_handle<> coroutine) { loop.watch(handle, write, coroutine); }
+				void await_resume() const noexcept { }
+			private:
+				EventLoop& loop;
+				SocketHandle handle;
+				bool write;
+		};
+
+		class SleepAwaiter
+		{
+			public:
+				SleepAwaiter(EventLoop& loop, std::chrono::milliseconds delay) :
+					loop{ loop },
+					delay{ delay }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return false; }
+
+				void await_suspend(std::coroutine_handle<> coroutine)
+				{
+					timer.callback = [this, coroutine]{ loop.schedule(coroutine); };
+					loop.timerWheel.schedule(timer, delay);
+				}
+
+				void await_resume() const noexcept { }
+			private:
+				EventLoop& loop;
+				std::chrono::milliseconds delay;
+				Timer timer;
+		};
+
+		EventLoop();
+		~EventLoop();
+
+		EventLoop(const EventLoop&) = delete;
+		EventLoop& operator=(const EventLoop&) = delete;
+
+		// runs until every spawned task finished or stop() was called
+		void run();
+		void stop();
+
+		void spawn(Task task);
+		void schedule(std::coroutine_handle<> coroutine);
+		void post(std::coroutine_handle<> coroutine);
+
+		inline IoAwaiter readable(SocketHandle handle) { return IoAwaiter(*this, handle, false); }
+		inline IoAwaiter writable(SocketHandle handle) { return IoAwaiter(*this, handle, true); }
+		inline SleepAwaiter sleep(std::chrono::milliseconds delay) { return SleepAwaiter(*this, delay); }
+
+		// resumes whoever waits on the socket so the pending operation can fail; call before closing it
+		void unwatch(SocketHandle handle);
+
+		inline TimerWheel& timers() { return timerWheel; }
+
+		void taskFinished(Task::Handle task);
+	private:
+		void watch(SocketHandle handle, bool write, std::coroutine_handle<> coroutine);
+		void runReady();
+		void pollSockets(int timeout);
+		void drainPosted();
+		void createWakeSocket();
+		void wake();
+
+		std::deque<std::coroutine_handle<>> ready;
+		std::map<SocketHandle, std::coroutine_handle<>> readers;
+		std::map<SocketHandle, std::coroutine_handle<>> writers;
+		std::vector<WSAPOLLFD> pollSet;
+		TimerWheel timerWheel;
+
+		std::mutex postedMutex;
+		std::vector<std::coroutine_handle<>> posted;
+		SocketHandle wakeSocket;
+
+		bool running;
+		int liveTasks;
+		std::exception_ptr failure;
+};
\ No newline at end of file
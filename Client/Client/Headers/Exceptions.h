@@ -29,6 +29,40 @@ class InterfaceException : public std::exception
 
 	}
 
+	const char* what() const throw()
+	{
+		return m_message.data();
+	}
+	private:
+	std::string m_message;
+};
+
+class ConnectionException : public std::exception
+{
+	public:
+	ConnectionException(const std::string& message) :
+		m_message(message)
+	{
+
+	}
+
+	const char* what() const throw()
+	{
+		return m_message.data();
+	}
+	private:
+	std::string m_message;
+};
+
+class EventLoopException : public std::exception
+{
+	public:
+	EventLoopException(const std::string& message) :
+		m_message(message)
+	{
+
+	}
+
 	const char* what() const throw()
 	{
 		return m_message.data();
@@ -2,6 +2,7 @@
 
 #include "Client.h"
 #include "Command.h"
+#include "Screen.h"
 
 #include <functional>
 #include <map>
@@ -19,7 +20,7 @@ class Interface
 		void run();
 		
 		void printMessage(const std::string& message);
-		std::string requestInput();
+		inline Screen& getScreen() { return screen; }
 	private:
 	     void readInputFromConsole(std::string& input);
 		 void parseInput(const std::string& input, std::string& command, std::vector<std::string>& arguments);
@@ -31,10 +32,13 @@ class Interface
 		void echo(const std::vector<std::string>& arguments);
 		void setUsername(const std::vector<std::string>& arguments);
 		void connectToServer(const std::vector<std::string>& arguments);
+		void spectate(const std::vector<std::string>& arguments);
 
 		bool running;
 		bool connected;
 
+		// declared before the client, which draws on it from the moment it is made
+		Screen screen;
 		std::map<std::string, Command> commands;
 		std::unique_ptr<Client> client;
 };
\ No newline at end of file
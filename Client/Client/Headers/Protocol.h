@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Exceptions.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace protocol
+{
+	// upper bound on a client message payload, anything larger is treated as malformed
+	const int MAX_MESSAGE_LENGTH = 64 * 1024;
+	// sent instead of a player/choice index when the tsar's verdict was skipped
+	const int NO_WINNER = -1;
+	// clients send a heartbeat this often; a connection silent for longer than the idle timeout is dropped
+	const int HEARTBEAT_INTERVAL_MILLISECONDS = 5000;
+	const int IDLE_TIMEOUT_MILLISECONDS = 20000;
+	// time a new connection has to send its username
+	const int HANDSHAKE_TIMEOUT_MILLISECONDS = 10000;
+	// a client that lost its connection retries this many times before giving up
+	const int RECONNECT_ATTEMPTS = 5;
+	const int RECONNECT_DELAY_MILLISECONDS = 2000;
+}
+
+// issued when a player joins, lets a new connection take over the player's seat
+using SessionToken = unsigned long long;
+
+// first thing a new connection sends
+enum class HandshakeType : int
+{
+	Join = 0,
+	Resume = 1,
+	// watches the table without a seat, the server only ever sends frames to it
+	Spectate = 2
+};
+
+/*
+	A spectator is sent a length-prefixed frame with the whole table every time it changes:
+	stage, round, number of rounds, players with their scores, tsar, prompt, the choices in
+	the order the tsar sees them (without their authors, and none before they are revealed),
+	then the chosen position and the round's winner (NO_WINNER before the verdict).
+*/
+enum class TableStage : int
+{
+	Dealt = 0,
+	ChoicesRevealed = 1,
+	Judged = 2
+};
+
+/*
+	Client to server messages, in the order they are sent during a round. Every message is
+	framed by a MessageHeader so the server can read it without knowing what to expect and
+	discard replies that arrive after their phase was closed.
+*/
+enum class MessageType : int
+{
+	StatementCardChoice = 0,
+	TsarChoice = 1,
+	NextRoundConfirmation = 2,
+	// keeps an idle connection alive, never queued for a phase
+	Heartbeat = 3
+};
+
+class MessageHeader
+{
+	public:
+		int type;
+		int round;
+		int length;
+};
+
+class Message
+{
+	public:
+		MessageType type;
+		int round;
+		std::vector<char> payload;
+};
+
+class MessageWriter
+{
+	public:
+		void writeInt(int value)
+		{
+			const char* bytes = reinterpret_cast<const char*>(&value);
+			payload.insert(payload.end(), bytes, bytes + sizeof(int));
+		}
+
+		void writeString(const std::string& text)
+		{
+			writeInt(text.length());
+			payload.insert(payload.end(), text.begin(), text.end());
+		}
+
+		inline const std::vector<char>& getPayload() const { return payload; }
+	private:
+		std::vector<char> payload;
+};
+
+class MessageReader
+{
+	public:
+		MessageReader(const Message& message) :
+			payload{ message.payload },
+			offset{ 0 }
+		{
+
+		}
+
+		int readInt()
+		{
+			int value;
+			require(sizeof(int));
+			std::memcpy(&value, &payload[offset], sizeof(int));
+			offset += sizeof(int);
+			return value;
+		}
+
+		std::string readString()
+		{
+			int length = readInt();
+			if (length < 0)
+			{
+				throw ConnectionException("Malformed message.");
+			}
+			require(length);
+			std::string text(payload.begin() + offset, payload.begin() + offset + length);
+			offset += length;
+			return text;
+		}
+	private:
+		void require(int size)
+		{
+			if (offset + size > payload.size())
+			{
+				throw ConnectionException("Malformed message.");
+			}
+		}
+
+		const std::vector<char>& payload;
+		int offset;
+};
\ No newline at end of file
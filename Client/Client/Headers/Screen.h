@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace screen
+{
+	// used when the output isn't a console whose size can be asked for
+	const int DEFAULT_ROWS = 25;
+	const int DEFAULT_COLUMNS = 80;
+}
+
+/*
+	Double-buffered console screen drawn with ANSI escape sequences. Text is printed into the
+	next frame, present() compares it row by row with what the console already shows and
+	writes only the rows that differ, all in one write. The row being typed in sits below the
+	text; the cursor is left at its end.
+	Rows are counted from the cursor, so the diff still works after the console has scrolled;
+	a change to a row that has scrolled out of view redraws everything.
+*/
+class Screen
+{
+	public:
+		Screen();
+
+		Screen(const Screen&) = delete;
+		Screen& operator=(const Screen&) = delete;
+
+		// starts a new, empty frame
+		void clear();
+		void print(std::string_view text);
+
+		void setPrompt(std::string_view prompt);
+		void setTyped(std::string_view typed);
+		// keeps the typed row as text, the way a terminal does when enter is pressed
+		void commitInput();
+
+		void present();
+	private:
+		void addRow(std::string_view row);
+		void moveTo(int row);
+		void queryConsoleSize();
+
+		// rows of the next frame; only the first numOfRows are used, so their memory is reused
+		std::vector<std::string> rows;
+		int numOfRows;
+		std::string prompt;
+		std::string typed;
+
+		// rows as the console shows them, the typed row last
+		std::vector<std::string> drawn;
+		int cursorRow;
+		bool redraw;
+		bool dirty;
+
+		int consoleRows;
+		int consoleColumns;
+		std::string output;
+};
\ No newline at end of file
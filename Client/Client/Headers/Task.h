@@ -0,0 +1,109 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+class EventLoop;
+
+/*
+	Lazily started coroutine. Awaiting a Task runs it to completion and resumes the awaiting
+	coroutine afterwards (symmetric transfer, so long chains don't grow the stack). A Task
+	handed to EventLoop::spawn is detached instead and frees itself once it finishes.
+*/
+class Task
+{
+	public:
+		class promise_type;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		class FinalAwaiter
+		{
+			public:
+				bool await_ready() const noexcept { return false; }
+				std::coroutine_handle<> await_suspend(Handle handle) noexcept;
+				void await_resume() const noexcept { }
+		};
+
+		class promise_type
+		{
+			public:
+				Task get_return_object() { return Task(Handle::from_promise(*this)); }
+				std::suspend_always initial_suspend() const noexcept { return {}; }
+				FinalAwaiter final_suspend() const noexcept { return {}; }
+				void return_void() { }
+				void unhandled_exception() { exception = std::current_exception(); }
+
+				std::coroutine_handle<> continuation;
+				std::exception_ptr exception;
+				EventLoop* owner = nullptr;
+		};
+
+		class Awaiter
+		{
+			public:
+				Awaiter(Handle handle) :
+					handle{ handle }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return !handle || handle.done(); }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept
+				{
+					handle.promise().continuation = awaitingCoroutine;
+					return handle;
+				}
+
+				void await_resume() const
+				{
+					if (handle.promise().exception)
+					{
+						std::rethrow_exception(handle.promise().exception);
+					}
+				}
+			private:
+				Handle handle;
+		};
+
+		Task() = default;
+		Task(Task&& other) noexcept :
+			handle{ std::exchange(other.handle, nullptr) }
+		{
+
+		}
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				destroy();
+				handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		}
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		~Task() { destroy(); }
+
+		Awaiter operator co_await() const noexcept { return Awaiter(handle); }
+
+		inline Handle release() { return std::exchange(handle, nullptr); }
+	private:
+		explicit Task(Handle handle) :
+			handle{ handle }
+		{
+
+		}
+
+		void destroy()
+		{
+			if (handle)
+			{
+				handle.destroy();
+				handle = nullptr;
+			}
+		}
+
+		Handle handle;
+};
\ No newline at end of file
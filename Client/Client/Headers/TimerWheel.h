@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+class TimerWheel;
+
+/*
+	Intrusive timer entry. The owner keeps it alive while it is scheduled; destroying a
+	scheduled timer cancels it.
+*/
+class Timer
+{
+	public:
+		Timer() = default;
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+		~Timer();
+
+		inline bool isScheduled() const { return wheel != nullptr; }
+		void cancel();
+
+		std::function<void()> callback;
+	private:
+		friend class TimerWheel;
+
+		TimerWheel* wheel = nullptr;
+		Timer** slot = nullptr;
+		Timer* previous = nullptr;
+		Timer* next = nullptr;
+		long long expiryTick = 0;
+		int level = 0;
+};
+
+/*
+	Hierarchical timer wheel. Level 0 has one slot per tick, every level above covers a whole
+	revolution of the one below per slot; when a lower level wraps around, the next slot of the
+	level above is cascaded down. Scheduling and cancelling are O(1) no matter how many timers
+	are pending, and the loop only has to wake up for ticks that actually have work.
+*/
+class TimerWheel
+{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(10));
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel& operator=(const TimerWheel&) = delete;
+
+		void schedule(Timer& timer, std::chrono::milliseconds delay);
+		void cancel(Timer& timer);
+
+		// fires every timer that expired up to now
+		void advance(Clock::time_point now);
+
+		// poll timeout until the next tick with work, -1 when nothing is scheduled
+		int millisecondsUntilNextExpiry(Clock::time_point now) const;
+
+		inline int size() const { return numOfTimers; }
+	private:
+		static const int SLOT_BITS = 6;
+		static const int SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+		static const int SLOT_MASK = SLOTS_PER_LEVEL - 1;
+		static const int NUM_OF_LEVELS = 4;
+
+		static inline long long levelSpan(int level) { return 1LL << (SLOT_BITS * level); }
+
+		void link(Timer& timer);
+		void unlink(Timer& timer);
+		void cascade(int level);
+		void expireCurrentSlot();
+
+		std::chrono::milliseconds resolution;
+		Clock::time_point startTime;
+		long long currentTick;
+		int numOfTimers;
+		int numOfNearTimers;
+		std::vector<Timer*> slots;
+		Timer* nextToVisit;
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "AsyncSocket.h"
+#include "Exceptions.h"
+#include "Protocol.h"
+
+AsyncSocket::AsyncSocket(EventLoop& loop, SocketHandle handle) :
+	loop{ loop },
+	handle{ handle },
+	closed{ false },
+	sending{ false }
+{
+	u_long nonBlocking = 1;
+	if (ioctlsocket(handle, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+	{
+		throw ConnectionException("Failed to make socket non-blocking, error " + std::to_string(WSAGetLastError()));
+	}
+}
+
+Task AsyncSocket::send(const void* data, int size)
+{
+	// the previous sender hands its turn over directly, so sending stays set while queued
+	co_await SendTurn(*this);
+	sending = true;
+	const char* buffer = static_cast<const char*>(data);
+	int sent = 0;
+	try
+	{
+		while (sent < size)
+		{
+			if (closed)
+			{
+				throw ConnectionException("Connection closed.");
+			}
+			int result = ::send(handle, buffer + sent, size - sent, 0);
+			if (result != SOCKET_ERROR)
+			{
+				sent += result;
+			}
+			else if (WSAGetLastError() == WSAEWOULDBLOCK)
+			{
+				co_await loop.writable(handle);
+			}
+			else
+			{
+				throw ConnectionException("send failed with error " + std::to_string(WSAGetLastError()));
+			}
+		}
+	}
+	catch (ConnectionException&)
+	{
+		finishSend();
+		throw;
+	}
+	finishSend();
+}
+
+Task AsyncSocket::receive(void* data, int size)
+{
+	char* buffer = static_cast<char*>(data);
+	int received = 0;
+	while (received < size)
+	{
+		if (closed)
+		{
+			throw ConnectionException("Connection closed.");
+		}
+		int result = ::recv(handle, buffer + received, size - received, 0);
+		if (result > 0)
+		{
+			received += result;
+		}
+		else if (result == 0)
+		{
+			throw ConnectionException("Connection closed by peer.");
+		}
+		else if (WSAGetLastError() == WSAEWOULDBLOCK)
+		{
+			co_await loop.readable(handle);
+		}
+		else
+		{
+			throw ConnectionException("recv failed with error " + std::to_string(WSAGetLastError()));
+		}
+	}
+}
+
+Task AsyncSocket::sendString(const std::string& text)
+{
+	int textLength = text.length();
+	co_await send(&textLength, sizeof(int));
+	co_await send(text.data(), textLength);
+}
+
+Task AsyncSocket::receiveString(std::string& text)
+{
+	int textLength;
+	co_await receive(&textLength, sizeof(int));
+	if (textLength < 0 || textLength > protocol::MAX_MESSAGE_LENGTH)
+	{
+		throw ConnectionException("Malformed string length.");
+	}
+	text.resize(textLength);
+	co_await receive(&text[0], textLength);
+}
+
+void AsyncSocket::close()
+{
+	if (!closed)
+	{
+		closed = true;
+		loop.unwatch(handle);
+		closesocket(handle);
+	}
+}
+
+void AsyncSocket::finishSend()
+{
+	if (sendQueue.empty())
+	{
+		sending = false;
+	}
+	else
+	{
+		loop.schedule(sendQueue.front());
+		sendQueue.pop_front();
+	}
+}
\ No newline at end of file
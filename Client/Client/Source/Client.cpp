@@ -1,14 +1,20 @@
 #include "Client.h"
 #include "Interface.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 Client::Client(Interface& userInterface):
 	wsaManager{ WSAManager::GetInstance() },
+	settingsFilepath{ "settings.cfg" },
 	socket{ Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) },
+	input{ loop, userInterface.getScreen() },
 	userInterface{ userInterface },
-	settingsFilepath{ "settings.cfg" }
+	spectating{ false },
+	phase{ Phase::WaitingForRound },
+	confirmationSent{ false }
 {
 	loadSettings();
 }
@@ -37,6 +43,8 @@ void Client::connectToServer()
 
 void Client::sendUsername()
 {
+	int handshakeType = static_cast<int>(HandshakeType::Join);
+	socket.Send(&handshakeType, sizeof(int));
 	int usernameLength = username.length();
 	socket.Send(&usernameLength, sizeof(int));
 	socket.Send(&username[0], usernameLength);
@@ -46,6 +54,20 @@ void Client::sendUsername()
 	{
 		throw std::exception("Invalid username!");
 	}
+	socket.Receive(&sessionToken, sizeof(SessionToken));
+}
+
+void Client::sendResumeRequest()
+{
+	int handshakeType = static_cast<int>(HandshakeType::Resume);
+	socket.Send(&handshakeType, sizeof(int));
+	socket.Send(&sessionToken, sizeof(SessionToken));
+	bool accepted = false;
+	socket.Receive(&accepted, sizeof(bool));
+	if (!accepted)
+	{
+		throw ConnectionException("Server refused to resume the session.");
+	}
 }
 
 void Client::receivePlayerList()
@@ -76,6 +98,7 @@ void Client::receiveNumOfAnswers()
 	int numOfAnswers;
 	socket.Receive(&numOfAnswers, sizeof(int));
 	statementCards.resize(numOfAnswers);
+	statementCardIds.resize(numOfAnswers);
 }
 
 void Client::start()
@@ -85,190 +108,358 @@ void Client::start()
 	receivePlayerList();
 	receiveNumOfRounds();
 	receiveNumOfAnswers();
-	sendThread = std::thread(&Client::send, this);
-	receiveThread = std::thread(&Client::receive, this);
-	receiveThread.join();
-	sendThread.join();
+	connection = std::make_unique<AsyncSocket>(loop, socket.GetHandle());
+	// keeps the server from dropping us as idle while the player thinks
+	heartbeat.callback = [this]
+	{
+		loop.spawn(sendHeartbeat());
+		loop.timers().schedule(heartbeat, std::chrono::milliseconds(protocol::HEARTBEAT_INTERVAL_MILLISECONDS));
+	};
+	loop.timers().schedule(heartbeat, std::chrono::milliseconds(protocol::HEARTBEAT_INTERVAL_MILLISECONDS));
+	input.start([this](const std::string& input){ onInput(input); });
+	loop.spawn(play());
+	userInterface.getScreen().present();
+	try
+	{
+		loop.run();
+	}
+	catch (ConnectionException& exception)
+	{
+		// the server drops players that time out or go idle
+		userInterface.printMessage("Disconnected from server: " + std::string(exception.what()));
+	}
+	userInterface.getScreen().present();
 }
 
-void Client::send()
+void Client::spectate()
 {
-	for (int i = 0; i < numOfRounds; i++)
+	int handshakeType = static_cast<int>(HandshakeType::Spectate);
+	socket.Send(&handshakeType, sizeof(int));
+	bool accepted = false;
+	socket.Receive(&accepted, sizeof(bool));
+	if (!accepted)
 	{
-		sendChoice_();
-		sendTsarChoice_();
-		sendConfirmation_();
-		resetData_();
+		userInterface.printMessage("The game is already over.");
+		userInterface.getScreen().present();
+		return;
 	}
+	spectating = true;
+	connection = std::make_unique<AsyncSocket>(loop, socket.GetHandle());
+	loop.spawn(watchTable());
+	userInterface.getScreen().present();
+	loop.run();
 }
 
-void Client::sendChoice_()
+Task Client::watchTable()
 {
-	std::unique_lock<std::mutex> dataReceivedLock(dataReceivedMutex);
-	dataReceived.wait(dataReceivedLock, [this]{ return doneReceivingData; });
-	if (playerID != tsarIndex)
+	// spectators only listen, the server sends a frame with the whole table whenever it changes
+	try
 	{
-		std::string finalChoice; //TODO: move this to a separate function
-		for (int j = 0; j < promptNumOfBlanks; j++)
+		Message frame;
+		while (true)
 		{
-			bool validInput = false;
-			std::vector<std::string> selectedStatementCards;
-			while (validInput == false)
+			int length;
+			co_await connection->receive(&length, sizeof(int));
+			if (length < 0 || length > protocol::MAX_MESSAGE_LENGTH)
 			{
-				std::string choice = userInterface.requestInput();
-				if (choice.length() != 1 && !isdigit(choice[0]))
-				{
-					userInterface.printMessage("Enter a digit corresponding to the statement card you wish to select.");
-				}
-				else if (choice[0] - '0' < 1 || choice[0] - '0' > statementCards.size())
-				{
-					userInterface.printMessage("Digit must be between 1-" + std::to_string(statementCards.size()));
-				}
-				else if (std::find(selectedStatementCards.begin(), selectedStatementCards.end(), choice) != selectedStatementCards.end())
-				{
-					userInterface.printMessage("Statement card already chosen.");
-				}
-				else
-				{
-					selectedStatementCards.emplace_back(choice);
-					finalChoice += choice;
-					validInput = true;
-				}
+				throw ConnectionException("Malformed frame.");
 			}
+			frame.payload.resize(length);
+			co_await connection->receive(frame.payload.data(), length);
+			displayTable(frame);
 		}
-		sendChoice(finalChoice);
-		sentChoice = true;
 	}
-	choiceSent.notify_all();
+	catch (ConnectionException&)
+	{
+		userInterface.printMessage("The server closed the table.");
+	}
+	userInterface.getScreen().present();
 }
 
-void Client::sendTsarChoice_()
+Task Client::play()
 {
-	if (playerID == tsarIndex)
+	// only the server's side of the round is awaited here, the player's answers are sent from
+	// the input handler as soon as they are complete
+	currentRound = 0;
+	while (currentRound < numOfRounds)
 	{
-		std::unique_lock<std::mutex> choicesReceivedLock(choicesReceivedMutex);
-		choicesReceived.wait(choicesReceivedLock, [this]{ return receivedChoices; });
-		choicesReceivedLock.unlock();
-		bool validInput = false;
-		std::string	choice;
-		while (validInput == false)
+		bool connectionLost = false;
+		try
 		{
-			choice = userInterface.requestInput();
-			if (choice.length() != 1 && !isdigit(choice[0]))
-			{
-				userInterface.printMessage("Enter a digit corresponding to the answer you wish to select.");
-			}
-			else if (choice[0] - '0' < 1 || choice[0] - '0' > playerList.size() - 1)
-			{
-				userInterface.printMessage("Digit must be between 1-" + std::to_string(statementCards.size()));
-			}
-			else
+			co_await receiveData_(currentRound);
+			co_await receiveStatementCardChoices_();
+			co_await receiveTsarChoice_();
+			co_await receiveConfirmation_();
+			currentRound++;
+		}
+		catch (ConnectionException& exception)
+		{
+			userInterface.printMessage("Connection lost: " + std::string(exception.what()));
+			userInterface.getScreen().present();
+			connectionLost = true;
+		}
+		resetData();
+		if (connectionLost)
+		{
+			enterPhase(Phase::WaitingForRound);
+			co_await resumeSession();
+		}
+	}
+	heartbeat.cancel();
+	input.stop();
+}
+
+Task Client::resumeSession()
+{
+	connection->close();
+	for (int attempt = 1; ; attempt++)
+	{
+		// also lets everything still using the old connection unwind before it is replaced
+		co_await loop.sleep(std::chrono::milliseconds(protocol::RECONNECT_DELAY_MILLISECONDS));
+		try
+		{
+			socket.Create();
+			socket.Connect(IPv4Address(serverIP, serverPort));
+			sendResumeRequest();
+			break;
+		}
+		catch (WinSockException&)
+		{
+			socket.Close();
+			if (attempt == protocol::RECONNECT_ATTEMPTS)
 			{
-				validInput = true;
+				throw ConnectionException("Could not reconnect to server.");
 			}
 		}
-		sendTsarChoice(choice);
-		m_sentTsarChoice = true;
 	}
-	m_tsarChoiceSent.notify_all();
+	connection = std::make_unique<AsyncSocket>(loop, socket.GetHandle());
+	userInterface.printMessage("Reconnected! Waiting for the next round.");
+	co_await receiveSnapshot();
+}
+
+Task Client::receiveData_(int i)
+{
+	co_await receiveTsarIndex();
+	co_await receivePrompt();
+	if (playerID != tsarIndex)
+	{
+		co_await receiveStatementCards();
+	}
+	displayInformation(i);
+	enterPhase(playerID != tsarIndex ? Phase::ChoosingCards : Phase::WaitingForChoices);
 }
 
-void Client::sendConfirmation_()
+Task Client::receiveStatementCardChoices_()
 {
-	std::unique_lock<std::mutex> tsarChoiceReceivedLock(tsarChoiceReceivedMutex);
-	tsarChoiceReceived.wait(tsarChoiceReceivedLock, [this]{ return receivedTsarChoice; });
-	tsarChoiceReceivedLock.unlock();
-	confirmNextRound();
-	sentConfirmation = true;
-	confirmationSent.notify_all();
+	co_await receiveStatementCardChoices();
+	if (phase == Phase::ChoosingCards)
+	{
+		userInterface.printMessage("Out of time, the server played for you.");
+	}
+	displayChoices();
+	// nobody answered in time, so there is nothing to judge
+	enterPhase(playerID == tsarIndex && !statementCardChoices.empty() ? Phase::Judging : Phase::WaitingForVerdict);
+}
+
+Task Client::receiveTsarChoice_()
+{
+	co_await receiveTsarChoice();
+	if (phase == Phase::Judging)
+	{
+		userInterface.printMessage("Out of time.");
+	}
+	displayTsarChoice();
+	enterPhase(Phase::Confirming);
 }
 
-void Client::resetData_()
+Task Client::receiveConfirmation_()
 {
-	std::unique_lock<std::mutex> receivedConfirmationLock(confirmationReceivedMutex);
-	confirmationReceived.wait(receivedConfirmationLock, [this]{return receivedConfirmation; });
-	receivedConfirmationLock.unlock();
-	resetData();
-	flagsReset = true;
-	resetFlags.notify_all();
+	co_await receiveServerConfirmation();
+	enterPhase(Phase::WaitingForRound);
 }
 
-void Client::receive()
+void Client::enterPhase(Phase phase)
 {
-	for (int i = 0; i < numOfRounds; i++)
+	// a confirmation sent early answers the phase before it starts
+	if (phase == Phase::Confirming && confirmationSent)
+	{
+		phase = Phase::WaitingForConfirmation;
+	}
+	this->phase = phase;
+	if (phase == Phase::Confirming)
+	{
+		userInterface.printMessage("Press any key to continue:");
+	}
+	if (acceptsInput())
+	{
+		showPrompt();
+	}
+	else
+	{
+		userInterface.getScreen().setPrompt("");
+	}
+	// answers typed ahead are used up by the phases they can answer
+	while ((acceptsInput() || canConfirmEarly()) && !pendingInputs.empty())
 	{
-		receiveData_(i);
-		receiveStatementCardChoices_();
-		receiveTsarChoice_();
-		receiveConfirmation_();
+		std::string input = std::move(pendingInputs.front());
+		pendingInputs.pop_front();
+		handleInput(input);
 	}
+	userInterface.getScreen().present();
 }
 
-void Client::receiveData_(int i)
+bool Client::acceptsInput() const
 {
-	receiveTsarIndex();
-	receivePrompt();
-	if (playerID != tsarIndex)
+	return phase == Phase::ChoosingCards || phase == Phase::Judging || phase == Phase::Confirming;
+}
+
+bool Client::canConfirmEarly() const
+{
+	// the tsar still has to judge while the others choose
+	return !confirmationSent && (phase == Phase::WaitingForVerdict || (phase == Phase::WaitingForChoices && playerID != tsarIndex));
+}
+
+void Client::onInput(const std::string& input)
+{
+	if ((acceptsInput() || canConfirmEarly()) && pendingInputs.empty())
 	{
-		receiveStatementCards();
+		handleInput(input);
+	}
+	else
+	{
+		pendingInputs.emplace_back(input);
 	}
-	doneReceivingData = true;
-	displayInformation(i);
-	dataReceived.notify_all();
 }
 
-void Client::receiveStatementCardChoices_()
+void Client::handleInput(const std::string& input)
 {
-	std::unique_lock<std::mutex> choiceSentLock(choiceSentMutex);
-	choiceSent.wait(choiceSentLock, [this]{ return sentChoice || playerID == tsarIndex; });
-	choiceSentLock.unlock();
-	receiveStatementCardChoices();
-	displayChoices();
-	receivedChoices = true;
-	choicesReceived.notify_all();
+	switch (phase)
+	{
+		case Phase::ChoosingCards: chooseStatementCard(input); break;
+		case Phase::Judging: chooseWinner(input); break;
+		case Phase::Confirming:
+			sendConfirmation();
+			enterPhase(Phase::WaitingForConfirmation);
+			break;
+		default:
+			// nothing left to answer this round, so any key confirms the next one ahead of time
+			sendConfirmation();
+			userInterface.printMessage("Ready for the next round.");
+			break;
+	}
 }
 
-void Client::receiveTsarChoice_()
+void Client::chooseStatementCard(const std::string& input)
 {
-	std::unique_lock<std::mutex> tsarChoiceSentLock(m_tsarChoiceSentMutex);
-	m_tsarChoiceSent.wait(tsarChoiceSentLock, [this]{ return m_sentTsarChoice || playerID != tsarIndex; });
-	tsarChoiceSentLock.unlock();
-	receiveTsarChoice();
-	displayTsarChoice();
-	receivedTsarChoice = true;
-	tsarChoiceReceived.notify_all();
+	int choiceIndex = parseChoice(input, statementCards.size(), "Enter a digit corresponding to the statement card you wish to select.");
+	if (choiceIndex >= 0 && std::find(selectedStatementCards.begin(), selectedStatementCards.end(), choiceIndex) != selectedStatementCards.end())
+	{
+		userInterface.printMessage("Statement card already chosen.");
+		choiceIndex = -1;
+	}
+	if (choiceIndex >= 0)
+	{
+		selectedStatementCards.emplace_back(choiceIndex);
+	}
+	if (selectedStatementCards.size() < promptNumOfBlanks)
+	{
+		showPrompt();
+		return;
+	}
+	sendChoice();
+	enterPhase(Phase::WaitingForChoices);
+}
+
+void Client::chooseWinner(const std::string& input)
+{
+	int choiceIndex = parseChoice(input, statementCardChoices.size(), "Enter a digit corresponding to the answer you wish to select.");
+	if (choiceIndex < 0)
+	{
+		showPrompt();
+		return;
+	}
+	sendTsarChoice(choiceIndex);
+	enterPhase(Phase::WaitingForVerdict);
+}
+
+int Client::parseChoice(const std::string& input, int numOfOptions, const std::string& hint)
+{
+	if (input.length() != 1 || !isdigit(input[0]))
+	{
+		userInterface.printMessage(hint);
+		return -1;
+	}
+	int choice = input[0] - '0';
+	if (choice < 1 || choice > numOfOptions)
+	{
+		userInterface.printMessage("Digit must be between 1-" + std::to_string(numOfOptions));
+		return -1;
+	}
+	return choice - 1;
+}
+
+void Client::showPrompt()
+{
+	userInterface.getScreen().setPrompt(">");
+}
+
+void Client::sendChoice()
+{
+	MessageWriter writer;
+	for (int choiceIndex : selectedStatementCards)
+	{
+		writer.writeInt(statementCardIds[choiceIndex]);
+	}
+	loop.spawn(submit(MessageType::StatementCardChoice, currentRound, std::move(writer)));
 }
 
-void Client::receiveConfirmation_()
+void Client::sendTsarChoice(int choiceIndex)
 {
-	std::unique_lock<std::mutex> confirmationSentLock(confirmationSentMutex);
-	confirmationSent.wait(confirmationSentLock, [this]{ return sentConfirmation; });
-	confirmationSentLock.unlock();
-	receiveServerConfirmation();
-	receivedConfirmation = true;
-	confirmationReceived.notify_all();
-	std::unique_lock<std::mutex> resetFlagsLock(resetFlagsMutex);
-	resetFlags.wait(resetFlagsLock, [this]{ return flagsReset; });
-	resetFlagsLock.unlock();
+	MessageWriter writer;
+	writer.writeInt(choiceIndex);
+	loop.spawn(submit(MessageType::TsarChoice, currentRound, std::move(writer)));
 }
 
+void Client::sendConfirmation()
+{
+	confirmationSent = true;
+	loop.spawn(submit(MessageType::NextRoundConfirmation, currentRound, MessageWriter()));
+}
 
-void Client::sendChoice(const std::string& choice)
+Task Client::submit(MessageType type, int round, MessageWriter writer)
 {
-	for (int i = 0; i < promptNumOfBlanks; i++)
+	try
+	{
+		co_await sendMessage(type, round, writer);
+	}
+	catch (ConnectionException&)
 	{
-		int choiceInt = choice[i] - '0' - 1;
-		socket.Send(&choiceInt, sizeof(int));
-		int answerLength = statementCards[choiceInt].length();
-		socket.Send(&answerLength, sizeof(int));
-		socket.Send(&statementCards[choiceInt][0], answerLength);
+		// the receiving side notices the broken connection and resumes the session
 	}
 }
 
-void Client::sendTsarChoice(const std::string& choice)
+Task Client::sendMessage(MessageType type, int round, const MessageWriter& writer)
+{
+	// the round lets the server throw away answers to a phase that already timed out
+	MessageHeader header{ static_cast<int>(type), round, static_cast<int>(writer.getPayload().size()) };
+	// one send per frame, so a heartbeat can't end up between a header and its payload
+	std::vector<char> frame(sizeof(MessageHeader) + header.length);
+	std::memcpy(frame.data(), &header, sizeof(MessageHeader));
+	std::copy(writer.getPayload().begin(), writer.getPayload().end(), frame.begin() + sizeof(MessageHeader));
+	co_await connection->send(frame.data(), frame.size());
+}
+
+Task Client::sendHeartbeat()
 {
-	int choiceInt = atoi(choice.c_str()) - 1;
-	socket.Send(&choiceInt, sizeof(int));
+	try
+	{
+		MessageWriter writer;
+		co_await sendMessage(MessageType::Heartbeat, currentRound, writer);
+	}
+	catch (ConnectionException&)
+	{
+		// the game's own send or receive reports the broken connection
+	}
 }
 
 void Client::receivePlayerID()
@@ -276,73 +467,98 @@ void Client::receivePlayerID()
 	socket.Receive(&playerID, sizeof(int));
 }
 
-void Client::receiveTsarIndex()
+Task Client::receiveSnapshot()
+{
+	// sent ahead of the round this client rejoins in
+	co_await connection->receive(&currentRound, sizeof(int));
+	int numOfPlayers;
+	co_await connection->receive(&numOfPlayers, sizeof(int));
+	for (int i = 0; i < numOfPlayers; i++)
+	{
+		co_await connection->receive(&playerList[i].first, sizeof(int));
+	}
+	int numOfStatementCards;
+	co_await connection->receive(&numOfStatementCards, sizeof(int));
+	statementCards.resize(numOfStatementCards);
+	statementCardIds.resize(numOfStatementCards);
+	for (int i = 0; i < numOfStatementCards; i++)
+	{
+		co_await connection->receive(&statementCardIds[i], sizeof(int));
+		co_await connection->receiveString(statementCards[i]);
+	}
+}
+
+Task Client::receiveTsarIndex()
 {
-	socket.Receive(&tsarIndex, sizeof(int));
+	co_await connection->receive(&tsarIndex, sizeof(int));
 }
 
-void Client::receivePrompt()
+Task Client::receivePrompt()
 {
-	int questionLength;
-	socket.Receive(&questionLength, sizeof(int));
-	prompt.resize(questionLength);
-	socket.Receive(&prompt[0], questionLength);
-	socket.Receive(&promptNumOfBlanks, sizeof(int));
+	co_await connection->receiveString(prompt);
+	co_await connection->receive(&promptNumOfBlanks, sizeof(int));
 }
 
-void Client::receiveStatementCards()
+Task Client::receiveStatementCards()
 {
 	int numOfAnswers;
-	socket.Receive(&numOfAnswers, sizeof(int));
+	co_await connection->receive(&numOfAnswers, sizeof(int));
 	for (int i = 0; i < numOfAnswers; i++)
 	{
-		int questionLength;
-		socket.Receive(&questionLength, sizeof(int));
-		std::string question;
-		question.resize(questionLength);
-		socket.Receive(&question[0], questionLength);
-		statementCards[i] = question;
+		co_await connection->receive(&statementCardIds[i], sizeof(int));
+		co_await connection->receiveString(statementCards[i]);
 	}
 }
 
-void Client::receiveStatementCardChoices()
+Task Client::receiveStatementCardChoices()
 {
 	int numOfAnswers;
-	socket.Receive(&numOfAnswers, sizeof(int));
+	co_await connection->receive(&numOfAnswers, sizeof(int));
+	if (numOfAnswers < 0 || numOfAnswers > playerList.size())
+	{
+		throw ConnectionException("Malformed player choices.");
+	}
 	for (int i = 0; i < numOfAnswers; i++)
 	{
+		// a hand that ran short is autoplayed with fewer cards than the prompt has blanks
+		int numOfCards;
+		co_await connection->receive(&numOfCards, sizeof(int));
+		if (numOfCards < 0 || numOfCards > promptNumOfBlanks)
+		{
+			throw ConnectionException("Malformed player choices.");
+		}
 		std::vector<std::string> answers;
-		for (int j = 0; j < promptNumOfBlanks; j++)
+		for (int j = 0; j < numOfCards; j++)
 		{
-			int answerLength;
 			std::string answer;
-			socket.Receive(&answerLength, sizeof(int));
-			answer.resize(answerLength);
-			socket.Receive(&answer[0], answerLength);
+			co_await connection->receiveString(answer);
 			answers.emplace_back(answer);
 		}
 		statementCardChoices.emplace_back(answers);
 	}
 }
 
-void Client::receiveTsarChoice()
+Task Client::receiveTsarChoice()
 {
-	socket.Receive(&winnerIndex, sizeof(int));
-	playerList[winnerIndex].first++;
-	socket.Receive(&tsarChoiceIndex, sizeof(int));
+	co_await connection->receive(&winnerIndex, sizeof(int));
+	if (winnerIndex != protocol::NO_WINNER)
+	{
+		playerList[winnerIndex].first++;
+	}
+	co_await connection->receive(&tsarChoiceIndex, sizeof(int));
 }
 
-void Client::receiveServerConfirmation()
+Task Client::receiveServerConfirmation()
 {
 	bool confirmation;
-	socket.Receive(&confirmation, sizeof(bool));
+	co_await connection->receive(&confirmation, sizeof(bool));
 }
 
 void Client::displayInformation(int round)
 {
-	system("cls");
+	userInterface.getScreen().clear();
 	userInterface.printMessage("Round #" + std::to_string(round + 1));
-	userInterface.printMessage("Player: " + playerList[playerID].second);
+	userInterface.printMessage(spectating ? "Spectating" : "Player: " + playerList[playerID].second);
 	userInterface.printMessage("Player list:");
 	for (int i = 0; i < playerList.size(); i++)
 	{
@@ -356,7 +572,7 @@ void Client::displayInformation(int round)
 		}
 	}
 	userInterface.printMessage(prompt + "\n");
-	if (playerID != tsarIndex)
+	if (!spectating && playerID != tsarIndex)
 	{
 		for (int i = 0; i < statementCards.size(); i++)
 		{
@@ -370,45 +586,76 @@ void Client::displayChoices()
 	userInterface.printMessage("Player choices:\n");
 	for (auto& choice : statementCardChoices)
 	{
-		std::string completeChoice;
-		for (int i = 0; i < choice.size() - 1; i++)
-		{
-			completeChoice += choice[i] + " / ";
-		}
-		completeChoice += choice[choice.size() - 1];
-		userInterface.printMessage(completeChoice);
+		userInterface.printMessage(joinChoice(choice));
 	}
 }
 
 void Client::displayTsarChoice()
 {
+	if (tsarChoiceIndex < 0 || tsarChoiceIndex >= statementCardChoices.size())
+	{
+		userInterface.printMessage("No winner this round.");
+		return;
+	}
 	userInterface.printMessage("Tsar choice:\n");
-	std::string completeChoice;
-	for (int i = 0; i < statementCardChoices[tsarChoiceIndex].size() - 1; i++)
+	userInterface.printMessage(joinChoice(statementCardChoices[tsarChoiceIndex]));
+}
+
+std::string Client::joinChoice(const std::vector<std::string>& choice)
+{
+	if (choice.empty())
 	{
-		completeChoice += statementCardChoices[tsarChoiceIndex][i] + " / ";
+		return "(no cards)";
 	}
-	completeChoice += statementCardChoices[tsarChoiceIndex][statementCardChoices[tsarChoiceIndex].size() - 1];
-	userInterface.printMessage(completeChoice);
+	std::string completeChoice = choice.front();
+	for (int i = 1; i < choice.size(); i++)
+	{
+		completeChoice += " / " + choice[i];
+	}
+	return completeChoice;
 }
 
-void Client::confirmNextRound()
+void Client::displayTable(const Message& frame)
 {
-	userInterface.printMessage("Press any key to continue:");
-	while (userInterface.requestInput().length() == 0);
-	bool confirmed;
-	socket.Send(&confirmed, sizeof(bool));
+	MessageReader reader(frame);
+	TableStage stage = static_cast<TableStage>(reader.readInt());
+	int round = reader.readInt();
+	numOfRounds = reader.readInt();
+	playerList.resize(reader.readInt());
+	for (auto& player : playerList)
+	{
+		player.second = reader.readString();
+		player.first = reader.readInt();
+	}
+	tsarIndex = reader.readInt();
+	prompt = reader.readString();
+	statementCardChoices.resize(reader.readInt());
+	for (auto& choice : statementCardChoices)
+	{
+		choice.resize(reader.readInt());
+		for (auto& statementCard : choice)
+		{
+			statementCard = reader.readString();
+		}
+	}
+	tsarChoiceIndex = reader.readInt();
+	winnerIndex = reader.readInt();
+
+	displayInformation(round);
+	if (stage != TableStage::Dealt)
+	{
+		displayChoices();
+	}
+	if (stage == TableStage::Judged)
+	{
+		displayTsarChoice();
+	}
+	userInterface.getScreen().present();
 }
 
 void Client::resetData()
 {
-	doneReceivingData = false;
-	sentChoice = false;
-	receivedChoices = false;
-	m_sentTsarChoice = false;
-	receivedTsarChoice = false;
-	flagsReset = false;
-	sentConfirmation = false;
-	receivedConfirmation = false;
 	statementCardChoices.clear();
+	selectedStatementCards.clear();
+	confirmationSent = false;
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "ConsoleInput.h"
+
+#include <cctype>
+#include <conio.h>
+#include <sstream>
+
+ConsoleInput::ConsoleInput(EventLoop& loop, Screen& screen) :
+	loop{ loop },
+	screen{ screen },
+	running{ false }
+{
+
+}
+
+void ConsoleInput::start(const InputHandler& handler)
+{
+	this->handler = handler;
+	running = true;
+	pollTimer.callback = [this]{ poll(); };
+	loop.timers().schedule(pollTimer, std::chrono::milliseconds(console::POLL_INTERVAL_MILLISECONDS));
+}
+
+void ConsoleInput::stop()
+{
+	running = false;
+	pollTimer.cancel();
+}
+
+void ConsoleInput::poll()
+{
+	// keys are read unbuffered, so echoing and erasing them is up to us
+	bool typed = false;
+	while (_kbhit())
+	{
+		int key = _getch();
+		if (key == 0 || key == 0xE0)
+		{
+			_getch(); // second half of an arrow or function key
+		}
+		else if (key == '\r' || key == '\n')
+		{
+			if (typed)
+			{
+				screen.setTyped(line);
+				typed = false;
+			}
+			screen.commitInput();
+			finishLine();
+		}
+		else if (key == '\b')
+		{
+			if (!line.empty())
+			{
+				line.pop_back();
+				typed = true;
+			}
+		}
+		else if (std::isprint(key))
+		{
+			line += static_cast<char>(key);
+			typed = true;
+		}
+	}
+	if (typed)
+	{
+		screen.setTyped(line);
+	}
+	// one frame for everything typed and whatever the handler printed about it
+	screen.present();
+	// the handler may have stopped the input
+	if (running)
+	{
+		loop.timers().schedule(pollTimer, std::chrono::milliseconds(console::POLL_INTERVAL_MILLISECONDS));
+	}
+}
+
+void ConsoleInput::finishLine()
+{
+	// words count separately, as they did when input was read with >>
+	std::istringstream words(line);
+	line.clear();
+	std::string word;
+	while (words >> word && running)
+	{
+		handler(word);
+	}
+}
\ No newline at end of file
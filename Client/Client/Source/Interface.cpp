@@ -4,8 +4,8 @@
 #include <sstream>
 
 Interface::Interface():
-	client{ std::make_unique<Client>(*this) },
-	connected{ false }
+	connected{ false },
+	client{ std::make_unique<Client>(*this) }
 {
 	setupCommands();
 }
@@ -51,16 +51,8 @@ void Interface::run()
 
 void Interface::printMessage(const std::string& message)
 {
-	std::cout << message << '\n';
-}
-
-std::string Interface::requestInput()
-{
-	std::cout.flush();
-	std::cout << ">";
-	std::string input;
-	std::cin >> input;
-	return input;
+	// shown with the next frame the client presents
+	screen.print(message);
 }
 
 void Interface::parseInput(const std::string& input, std::string& command, std::vector<std::string>& arguments)
@@ -94,6 +86,7 @@ void Interface::setupCommands()
 	commands["echo"] = Command(InterfaceCommand(std::bind(&Interface::echo, this, std::placeholders::_1)), "echo", cmd::UNLIMITED_ARGUMENTS);
 	commands["setuser"] = Command(InterfaceCommand(std::bind(&Interface::setUsername, this, std::placeholders::_1)), "setuser", 1);
 	commands["connect"] = Command(InterfaceCommand(std::bind(&Interface::connectToServer, this, std::placeholders::_1)), "connect", 0);
+	commands["spectate"] = Command(InterfaceCommand(std::bind(&Interface::spectate, this, std::placeholders::_1)), "spectate", 0);
 }
 
 void Interface::exit(const std::vector<std::string>& arguments)
@@ -125,4 +118,16 @@ void Interface::connectToServer(const std::vector<std::string>& arguments)
 	connected = true;
 	running = false;
 	client->start();
+}
+
+void Interface::spectate(const std::vector<std::string>& arguments)
+{
+	if (connected)
+	{
+		throw InterfaceException("Already connected");
+	}
+	client->connectToServer();
+	connected = true;
+	running = false;
+	client->spectate();
 }
\ No newline at end of file
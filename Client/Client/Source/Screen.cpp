@@ -0,0 +1,167 @@
+#include "Screen.h"
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <iostream>
+
+Screen::Screen() :
+	numOfRows{ 0 },
+	cursorRow{ 0 },
+	redraw{ true },
+	dirty{ false },
+	consoleRows{ screen::DEFAULT_ROWS },
+	consoleColumns{ screen::DEFAULT_COLUMNS }
+{
+	// escape sequences are only interpreted once the console is told to
+	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD mode = 0;
+	if (GetConsoleMode(console, &mode))
+	{
+		SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+	}
+	queryConsoleSize();
+}
+
+void Screen::clear()
+{
+	numOfRows = 0;
+	queryConsoleSize();
+	dirty = true;
+}
+
+void Screen::print(std::string_view text)
+{
+	size_t start = 0;
+	size_t end;
+	while ((end = text.find('\n', start)) != std::string_view::npos)
+	{
+		addRow(text.substr(start, end - start));
+		start = end + 1;
+	}
+	addRow(text.substr(start));
+	dirty = true;
+}
+
+void Screen::setPrompt(std::string_view prompt)
+{
+	this->prompt = prompt;
+	dirty = true;
+}
+
+void Screen::setTyped(std::string_view typed)
+{
+	this->typed = typed;
+	dirty = true;
+}
+
+void Screen::commitInput()
+{
+	addRow(prompt + typed);
+	prompt.clear();
+	typed.clear();
+	dirty = true;
+}
+
+void Screen::present()
+{
+	if (!dirty)
+	{
+		return;
+	}
+	dirty = false;
+	// the typed row is kept as more rows of the frame
+	int numOfTextRows = numOfRows;
+	addRow(prompt + typed);
+	int numOfLines = numOfRows;
+	numOfRows = numOfTextRows;
+
+	int first = 0;
+	while (first < numOfLines && first < drawn.size() && drawn[first] == rows[first])
+	{
+		first++;
+	}
+	output.clear();
+	if (redraw || cursorRow - first >= consoleRows)
+	{
+		output += "\x1b[H\x1b[2J";
+		cursorRow = 0;
+		drawn.clear();
+		first = 0;
+		redraw = false;
+	}
+	for (int i = first; i < numOfLines; i++)
+	{
+		if (i < drawn.size() && drawn[i] == rows[i])
+		{
+			continue;
+		}
+		moveTo(i);
+		output += rows[i];
+		output += "\x1b[K";
+		if (i < drawn.size())
+		{
+			drawn[i] = rows[i];
+		}
+		else
+		{
+			drawn.emplace_back(rows[i]);
+		}
+	}
+	moveTo(numOfLines - 1);
+	if (!rows[numOfLines - 1].empty())
+	{
+		output += "\x1b[" + std::to_string(rows[numOfLines - 1].size()) + "C";
+	}
+	// rows of a longer frame before are still below
+	if (drawn.size() > numOfLines)
+	{
+		output += "\x1b[J";
+		drawn.resize(numOfLines);
+	}
+	std::cout.write(output.data(), output.size());
+	std::cout.flush();
+}
+
+void Screen::addRow(std::string_view row)
+{
+	// long text is wrapped here, so every row takes exactly one line of the console; the last
+	// column stays free so the console never wraps on its own
+	int width = std::max(consoleColumns - 1, 1);
+	do
+	{
+		std::string_view part = row.substr(0, width);
+		if (numOfRows < rows.size())
+		{
+			rows[numOfRows] = part;
+		}
+		else
+		{
+			rows.emplace_back(part);
+		}
+		numOfRows++;
+		row.remove_prefix(part.size());
+	} while (!row.empty());
+}
+
+void Screen::moveTo(int row)
+{
+	if (row < cursorRow)
+	{
+		output += "\x1b[" + std::to_string(cursorRow - row) + "A";
+	}
+	// moving down past the last row has to scroll the console, which only a new line does
+	output.append(std::max(row - cursorRow, 0), '\n');
+	output += '\r';
+	cursorRow = row;
+}
+
+void Screen::queryConsoleSize()
+{
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+	{
+		consoleRows = info.srWindow.Bottom - info.srWindow.Top + 1;
+		consoleColumns = info.srWindow.Right - info.srWindow.Left + 1;
+	}
+}
\ No newline at end of file
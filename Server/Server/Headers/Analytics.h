@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Deck.h"
+#include "Executor.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Interface;
+
+namespace analytics
+{
+	// cards and prompts seen fewer times than this are left out of the rankings
+	const int MIN_PLAYS_FOR_RANKING = 10;
+	const int NUM_OF_RANKED = 5;
+	// more chunks than workers, so a chunk of long games doesn't leave the others idle
+	const int CHUNKS_PER_WORKER = 4;
+}
+
+/*
+	Offline card and prompt statistics over event logs, for curating decks. The log is split
+	into chunks where games start and every chunk is streamed from the file and decoded on the
+	executor into columns, one row per played card, which are then counted into dense per-deck
+	tables and merged. Games played side by side interleave in the log, so every event is counted
+	for the game its table was playing. Ids are checked against the size of the deck the game was
+	dealt from.
+*/
+class Analytics
+{
+	public:
+		Analytics(Interface& userInterface);
+
+		void run(const std::string& eventLogFilepath, const std::string& reportFilepath);
+	private:
+		class PlayColumns
+		{
+			public:
+				std::vector<int> deck;
+				std::vector<int> prompt;
+				std::vector<int> card;
+				std::vector<char> won;
+				std::vector<char> autoPlayed;
+		};
+
+		class RoundColumns
+		{
+			public:
+				std::vector<int> deck;
+				std::vector<int> prompt;
+				std::vector<char> hasWinner;
+		};
+
+		class PairStatistics
+		{
+			public:
+				unsigned long long key; // prompt in the high half, card in the low half
+				int plays;
+				int wins;
+		};
+
+		class DeckStatistics
+		{
+			public:
+				std::vector<int> cardPlays;
+				std::vector<int> cardWins;
+				std::vector<int> promptRounds;
+				std::vector<int> promptNoWinner;
+				std::vector<int> promptSubmissions;
+				std::vector<int> promptAutoPlayed;
+				std::vector<PairStatistics> pairs; // sorted by key
+		};
+
+		// one deck as a game recorded it, decks whose files changed between games count as different ones
+		class LoggedDeck
+		{
+			public:
+				std::string promptRepoFilepaths;
+				std::string statementCardRepoFilepaths;
+				bool hasVersion;
+				unsigned long long fingerprint;
+				int numOfPrompts;
+				int numOfStatementCards;
+				// the files as they are now, their texts only label the report if the fingerprint still matches
+				std::shared_ptr<const Deck> current;
+		};
+
+		using Statistics = std::vector<DeckStatistics>;
+
+		void indexGames(const std::string& eventLogFilepath);
+		void decodeChunk(const std::string& eventLogFilepath, int firstGame, int lastGame, PlayColumns& plays, RoundColumns& rounds) const;
+		// the game every table is playing where the given game starts in the log
+		std::map<int, int> findActiveGames(int game) const;
+		void countChunk(const PlayColumns& plays, const RoundColumns& rounds, Statistics& statistics) const;
+		void merge(Statistics& statistics, Statistics& chunkStatistics) const;
+		void report(const Statistics& statistics, const std::string& reportFilepath) const;
+
+		static void addAt(std::vector<int>& counts, int index, int amount);
+		static void addAll(std::vector<int>& counts, const std::vector<int>& chunkCounts);
+
+		Interface& userInterface;
+		Executor executor;
+
+		// where every game starts and last has an event in the log, at which table and with which decks it was played
+		std::vector<long long> gameOffsets;
+		std::vector<long long> gameEnds;
+		std::vector<int> gameTables;
+		std::vector<int> gameDecks;
+		std::vector<LoggedDeck> decks;
+		long long numOfPlays;
+};
\ No newline at end of file
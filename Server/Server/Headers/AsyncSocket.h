@@ -0,0 +1,45 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "GatherWriter.h"
+#include "SendQueue.h"
+#include "Task.h"
+#include "WNetwok.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+/*
+	Non-blocking view of an already connected socket. receive transfers the whole buffer,
+	suspending the calling coroutine on the event loop whenever the socket would block; send
+	hands the buffer to the connection's SendQueue and only suspends while that is over its
+	high watermark. Buffers are queued whole, so one is never interleaved with another.
+*/
+class AsyncSocket
+{
+	public:
+		AsyncSocket(EventLoop& loop, SocketHandle handle);
+
+		Task send(const void* data, int size);
+		// goes out in one WSASend with nothing copied, unless the socket can't take it all
+		Task send(const GatherWriter& message);
+		Task receive(void* data, int size);
+
+		Task sendString(std::string_view text);
+		Task receiveString(std::string& text);
+
+		// fails pending and future operations and drops unsent data; safe to call more than once
+		void close();
+		// closes once everything queued went out
+		void closeAfterSending();
+
+		inline void setWatermarks(int lowWatermark, int highWatermark) { sendQueue->setWatermarks(lowWatermark, highWatermark); }
+		inline const SendQueue& getSendQueue() const { return *sendQueue; }
+		inline SocketHandle getHandle() const { return handle; }
+		inline EventLoop& getLoop() { return loop; }
+	private:
+		EventLoop& loop;
+		SocketHandle handle;
+		std::shared_ptr<SendQueue> sendQueue;
+};
\ No newline at end of file
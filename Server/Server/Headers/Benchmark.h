@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+
+class Interface;
+
+namespace benchmark
+{
+	// threads meeting at the barrier, as many as a table's phase has participants and more
+	const int MAX_BARRIER_THREADS = 8;
+	const int BARRIER_PHASES = 20000;
+	// pending deadlines on a busy server: an idle timer per connection and a few per table
+	const int NUM_OF_TIMERS = 100000;
+	const int NUM_OF_TABLES = 1000;
+	// cards in the generated decks the snapshot benchmark deals from
+	const int DECK_SIZE = 5000;
+	// tables of autoplayed players each shard of the rounds benchmark plays out at once
+	const int TABLES_PER_SHARD = 64;
+	const int ROUNDS_PER_TABLE = 200;
+	// names in use on a crowded server, and the joins timed against them with a scan of every name
+	const int NUM_OF_USERS = 100000;
+	const int SCANNED_JOINS = 200;
+}
+
+/*
+	Measurements of the server's building blocks, run from the console as "benchmark <name>".
+	Each one sets up its own data, times the operation it is named after and prints the result,
+	next to the approach it replaced where there was one.
+*/
+class Benchmark
+{
+	public:
+		Benchmark(Interface& userInterface);
+
+		void run(const std::string& name);
+	private:
+		void latches();
+		void timers();
+		void snapshots();
+		void rounds();
+		void usernames();
+
+		void printResult(const std::string& what, std::chrono::steady_clock::duration elapsed, long long operations);
+
+		Interface& userInterface;
+		std::map<std::string, std::function<void()>> benchmarks;
+};
\ No newline at end of file
@@ -1,15 +1,32 @@
 #pragma once
 
+#include "AsyncSocket.h"
+#include "Inbox.h"
+#include "Protocol.h"
 #include "WNetwok.h"
 
+#include <memory>
 #include <string>
 
 class Client
 {
 	public:
+		/*
+			A resuming player has a new connection but keeps sitting out until the next round
+			starts, where it is sent a snapshot and picks the game back up.
+		*/
+		enum class ConnectionState
+		{
+			Connected,
+			Resuming,
+			Disconnected
+		};
+
 		Client() :
 			socket{ Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) },
-			score{ 0 }
+			score{ 0 },
+			sessionToken{ 0 },
+			state{ ConnectionState::Connected }
 		{
 
 		}
@@ -17,13 +34,69 @@ class Client
 		inline void setUsername(const std::string& username) { this->username = username; }
 		inline Socket& getSocket() { return socket; }
 		inline IPv4Address& getAddress() { return address; }
+		inline AsyncSocket& getConnection() { return *connection; }
+		inline Inbox& getInbox() { return *inbox; }
+		inline void setConnection(std::unique_ptr<AsyncSocket> connection)
+		{
+			// the old connection outlives the swap, coroutines woken by its close() still have to unwind
+			retiredConnection = std::move(this->connection);
+			this->connection = std::move(connection);
+			if (inbox)
+			{
+				inbox->reopen();
+			}
+			else
+			{
+				inbox = std::make_unique<Inbox>(this->connection->getLoop());
+			}
+		}
+		inline std::unique_ptr<AsyncSocket> releaseConnection() { return std::move(connection); }
+		// lets go of the connection's state on the loop it was opened on, the socket itself stays
+		// open for another loop to set a connection up on; nothing may be pending on it
+		inline void detachConnection()
+		{
+			connection.reset();
+			retiredConnection.reset();
+			inbox.reset();
+		}
+		inline void disconnect(bool afterSending = false)
+		{
+			state = ConnectionState::Disconnected;
+			// players restored from a checkpoint have no connection until they resume
+			if (connection)
+			{
+				inbox->close();
+				if (afterSending)
+				{
+					connection->closeAfterSending();
+				}
+				else
+				{
+					connection->close();
+				}
+			}
+		}
+		inline bool hasConnection() const { return connection != nullptr; }
+		inline bool isConnected() const { return state == ConnectionState::Connected; }
+		inline bool isResuming() const { return state == ConnectionState::Resuming; }
+		inline void setConnected() { state = ConnectionState::Connected; }
+		inline void setResuming() { state = ConnectionState::Resuming; }
+		inline void setDisconnected() { state = ConnectionState::Disconnected; }
+		inline SessionToken getSessionToken() const { return sessionToken; }
+		inline void setSessionToken(SessionToken sessionToken) { this->sessionToken = sessionToken; }
 		inline const std::string& getUsername() const { return username; }
 		inline int getScore() const { return score; }
 		inline void incrementScore() { score++; }
+		inline void setScore(int score) { this->score = score; }
 		inline bool operator==(const Client& client) { return username == client.username; }
 	private:
 		std::string username;
 		Socket socket;
 		IPv4Address address;
+		std::unique_ptr<AsyncSocket> connection;
+		std::unique_ptr<AsyncSocket> retiredConnection;
+		std::unique_ptr<Inbox> inbox;
 		int score;
+		SessionToken sessionToken;
+		ConnectionState state;
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Repository.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/*
+	Several repositories presented as one, for expansion packs. Nothing is copied: indices are
+	mapped to a part through a table of where every part starts, found with a binary search.
+*/
+template<typename T>
+class CompositeRepository : public Repository<T>
+{
+	public:
+		CompositeRepository(std::vector<std::shared_ptr<Repository<T>>> parts) :
+			parts{ std::move(parts) }
+		{
+			offsets.reserve(this->parts.size() + 1);
+			offsets.emplace_back(0);
+			for (auto& part : this->parts)
+			{
+				offsets.emplace_back(offsets.back() + part->size());
+			}
+		}
+
+		virtual const T& getObject(int index) const override
+		{
+			// offsets[part] <= index < offsets[part + 1]; empty parts share an offset with the next one
+			int part = std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin() - 1;
+			return parts[part]->getObject(index - offsets[part]);
+		}
+
+		virtual inline int size() override
+		{
+			return offsets.back();
+		}
+	private:
+		std::vector<std::shared_ptr<Repository<T>>> parts;
+		std::vector<int> offsets;
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CompositeRepository.h"
+#include "FileRepository.h"
+#include "Prompt.h"
+#include "Repository.h"
+#include "StatementCard.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace deck
+{
+	const unsigned long long FINGERPRINT_BASIS = 14695981039346656037ULL;
+	const unsigned long long FINGERPRINT_PRIME = 1099511628211ULL;
+}
+
+/*
+	One immutable version of the prompt and statement card decks. A game keeps the repositories
+	of the version it started with, so reloading the files never changes cards under it.
+	Each deck may be a comma separated list of files, an expansion pack per file.
+*/
+class Deck
+{
+	public:
+		Deck(int version, const std::string& promptRepoFilepaths, const std::string& statementCardRepoFilepaths) :
+			version{ version },
+			promptRepoFilepaths{ promptRepoFilepaths },
+			statementCardRepoFilepaths{ statementCardRepoFilepaths },
+			prompts{ loadPacks<Prompt>(promptRepoFilepaths) },
+			statementCards{ loadPacks<StatementCard>(statementCardRepoFilepaths) },
+			fingerprint{ deck::FINGERPRINT_BASIS }
+		{
+			fingerprintCards();
+		}
+
+		// cards made up in memory, for measurements that shouldn't depend on the deck files at hand
+		Deck(int version, std::shared_ptr<Repository<Prompt>> prompts, std::shared_ptr<Repository<StatementCard>> statementCards) :
+			version{ version },
+			prompts{ std::move(prompts) },
+			statementCards{ std::move(statementCards) },
+			fingerprint{ deck::FINGERPRINT_BASIS }
+		{
+			fingerprintCards();
+		}
+
+		static std::vector<std::string> splitFilepaths(const std::string& filepaths)
+		{
+			std::vector<std::string> split;
+			std::string filepath;
+			std::stringstream filepathStream(filepaths);
+			while (std::getline(filepathStream, filepath, ','))
+			{
+				if (!filepath.empty())
+				{
+					split.emplace_back(filepath);
+				}
+			}
+			return split;
+		}
+
+		inline int getVersion() const { return version; }
+		// the version only counts reloads within one run, the fingerprint tells decks apart across runs
+		inline unsigned long long getFingerprint() const { return fingerprint; }
+		inline const std::string& getPromptRepoFilepaths() const { return promptRepoFilepaths; }
+		inline const std::string& getStatementCardRepoFilepaths() const { return statementCardRepoFilepaths; }
+		inline const std::shared_ptr<Repository<Prompt>>& getPrompts() const { return prompts; }
+		inline const std::shared_ptr<Repository<StatementCard>>& getStatementCards() const { return statementCards; }
+	private:
+		template<typename T>
+		static std::shared_ptr<Repository<T>> loadPacks(const std::string& filepaths)
+		{
+			std::vector<std::shared_ptr<Repository<T>>> packs;
+			for (auto& filepath : splitFilepaths(filepaths))
+			{
+				packs.emplace_back(std::make_shared<FileRepository<T>>(filepath));
+			}
+			// a single pack needs no index mapping
+			if (packs.size() == 1)
+			{
+				return packs.front();
+			}
+			return std::make_shared<CompositeRepository<T>>(std::move(packs));
+		}
+
+		void fingerprintCards()
+		{
+			for (int i = 0; i < prompts->size(); i++)
+			{
+				addToFingerprint(prompts->getObject(i).text);
+				addToFingerprint(std::to_string(prompts->getObject(i).numOfBlanks));
+			}
+			for (int i = 0; i < statementCards->size(); i++)
+			{
+				addToFingerprint(statementCards->getObject(i).text);
+			}
+		}
+
+		// FNV-1a over every text, a line break after each so moving text between cards changes it
+		void addToFingerprint(std::string_view text)
+		{
+			for (char character : text)
+			{
+				fingerprint = (fingerprint ^ static_cast<unsigned char>(character)) * deck::FINGERPRINT_PRIME;
+			}
+			fingerprint = (fingerprint ^ '\n') * deck::FINGERPRINT_PRIME;
+		}
+
+		int version;
+		std::string promptRepoFilepaths;
+		std::string statementCardRepoFilepaths;
+		std::shared_ptr<Repository<Prompt>> prompts;
+		std::shared_ptr<Repository<StatementCard>> statementCards;
+		unsigned long long fingerprint;
+};
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Deck.h"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace deck
+{
+	const int POLL_INTERVAL_MILLISECONDS = 2000;
+}
+
+/*
+	Publishes the latest version of the decks. Reloads build a whole new Deck off the loop and
+	swap it in with one atomic store, readers take a reference with one atomic load; games
+	already running keep the version they started with.
+*/
+class DeckLibrary
+{
+	public:
+		DeckLibrary(const std::string& promptRepoFilepaths, const std::string& statementCardRepoFilepaths);
+
+		DeckLibrary(const DeckLibrary&) = delete;
+		DeckLibrary& operator=(const DeckLibrary&) = delete;
+
+		inline std::shared_ptr<const Deck> current() const { return deck.load(std::memory_order_acquire); }
+
+		// polled from one thread, true once for every change to any of the files
+		bool checkForChanges();
+		// loads the files into the next version and publishes it, a deck that failed to load is not published
+		void reload();
+	private:
+		std::vector<std::filesystem::file_time_type> lastWriteTimes() const;
+
+		std::string promptRepoFilepaths;
+		std::string statementCardRepoFilepaths;
+		std::vector<std::filesystem::file_time_type> writeTimes;
+		std::atomic<std::shared_ptr<const Deck>> deck;
+};
\ No newline at end of file
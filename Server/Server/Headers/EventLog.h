@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Snapshot.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class EventType : int
+{
+	GameStarted = 0,
+	RoundDealt = 1,
+	CardsSubmitted = 2,
+	WinnerChosen = 3,
+	GameEnded = 4,
+	// holds the events of one table since its last round, behind the table's number; the events of
+	// tables played side by side interleave round by round
+	TableEvents = 5
+};
+
+namespace eventlog
+{
+	// a batch is handed to the writer early once this much is buffered
+	const int BATCH_SIZE = 64 * 1024;
+	// read at a time when walking a log; a longer record grows the chunk to fit it
+	const int READ_CHUNK_SIZE = 1024 * 1024;
+	// far beyond any event the server writes, a longer length is a corrupt one
+	const int MAX_RECORD_SIZE = 16 * 1024 * 1024;
+}
+
+/*
+	Append-only record of every game played, for debugging and replays. Each event is stored as
+	its length, its type and a payload in the snapshot encoding. Events are buffered on the
+	loop thread and handed over in batches to a writer thread, so the game never waits on disk.
+	Tables hand their events over after every round, each round's go in as one TableEvents record.
+*/
+class EventLog
+{
+	public:
+		EventLog();
+		~EventLog();
+
+		EventLog(const EventLog&) = delete;
+		EventLog& operator=(const EventLog&) = delete;
+
+		// a restored game cuts off whatever was logged after its checkpoint, it is played again
+		void open(const std::string& filepath, long long truncatedSize = -1);
+		void close();
+
+		void append(EventType type, const SnapshotWriter& event);
+		// records encoded elsewhere with encode(), all of them of the given table
+		void appendTableRecords(int table, const std::vector<char>& records);
+		void flush();
+
+		// adds the event to records in the log's record format
+		static void encode(std::vector<char>& records, EventType type, const SnapshotWriter& event);
+
+		// bytes appended so far, including the ones still on their way to the file
+		inline long long size() const { return appended; }
+	private:
+		void writeBatches();
+
+		std::ofstream file;
+		std::thread writer;
+		std::mutex batchGuard;
+		std::condition_variable batchReady;
+		std::vector<char> buffered;
+		std::vector<char> pending;
+		bool stopping;
+		long long appended;
+};
+
+/*
+	Walks the records of an event log file, or of the byte range [begin, end) of it, reading
+	the file in fixed-size chunks so a log of any size is never loaded whole. A record that
+	doesn't fit in what is left is what a crash halfway through a batch leaves behind, reading
+	stops there. The events in a TableEvents record are walked one by one like any other, with
+	the table they belong to. The event of the current record is only valid until the next call
+	to next().
+*/
+class EventLogReader
+{
+	public:
+		EventLogReader(const std::string& filepath, long long begin = 0, long long end = -1);
+
+		EventLogReader(const EventLogReader&) = delete;
+		EventLogReader& operator=(const EventLogReader&) = delete;
+
+		bool next();
+
+		// the payload of the current record, fields a newer server added at the end are left unread
+		inline SnapshotReader getEvent() const { return SnapshotReader(chunk, recordPosition + 2 * sizeof(int), recordEnd); }
+
+		inline EventType getType() const { return type; }
+		// the table whose events hold the current record, 0 in logs that kept every game in one piece
+		inline int getTable() const { return table; }
+		// where a reader has to start to read the current record again: the record itself, or its table's events
+		inline long long getRecordOffset() const { return recordOffset; }
+		// where the next record starts, after a partial record that is the end of the usable log
+		inline long long getOffset() const { return chunkOffset + position; }
+		inline bool isTruncated() const { return truncated; }
+	private:
+		// makes at least size bytes from position on available in the chunk, false at the end of the range
+		bool fill(int size);
+
+		std::ifstream file;
+		std::vector<char> chunk;
+		long long chunkOffset; // where chunk[0] is in the file
+		int position;
+		int available;
+		long long end;
+		long long recordOffset;
+		int recordPosition;
+		int recordEnd;
+		// end of the table's events the reader is in, where the next record outside of them starts
+		int tableEventsEnd;
+		EventType type;
+		int table;
+		bool truncated;
+};
+
+/*
+	Payload of a GameStarted event. Logs written before the deck fields were added end after
+	the usernames; hasDeckVersion tells whether the rest was recorded.
+*/
+class GameStartedEvent
+{
+	public:
+		GameStartedEvent(SnapshotReader& event) :
+			seed{ static_cast<unsigned int>(event.readInt()) },
+			numOfPlayers{ event.readInt() },
+			numOfRounds{ event.readInt() },
+			numOfStatementCards{ event.readInt() },
+			promptRepoFilepaths{ event.readString() },
+			statementCardRepoFilepaths{ event.readString() },
+			hasDeckVersion{ false },
+			deckVersion{ 0 },
+			deckFingerprint{ 0 },
+			numOfPromptsInDeck{ 0 },
+			numOfStatementCardsInDeck{ 0 }
+		{
+			for (int i = 0; i < numOfPlayers; i++)
+			{
+				usernames.emplace_back(event.readString());
+			}
+			if (!event.isAtEnd())
+			{
+				hasDeckVersion = true;
+				deckVersion = event.readInt();
+				deckFingerprint = event.readLongLong();
+				numOfPromptsInDeck = event.readInt();
+				numOfStatementCardsInDeck = event.readInt();
+			}
+		}
+
+		unsigned int seed;
+		int numOfPlayers;
+		int numOfRounds;
+		int numOfStatementCards;
+		std::string promptRepoFilepaths;
+		std::string statementCardRepoFilepaths;
+		std::vector<std::string> usernames;
+		bool hasDeckVersion;
+		int deckVersion;
+		unsigned long long deckFingerprint;
+		int numOfPromptsInDeck;
+		int numOfStatementCardsInDeck;
+};
\ No newline at end of file
@@ -46,6 +46,108 @@ class StdRandGeneratorException : public std::exception
 
 		}
 
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class ConnectionException : public std::exception
+{
+	public:
+		ConnectionException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class EventLoopException : public std::exception
+{
+	public:
+		EventLoopException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class SeededGeneratorException : public std::exception
+{
+	public:
+		SeededGeneratorException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class SnapshotException : public std::exception
+{
+	public:
+		SnapshotException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class EventLogException : public std::exception
+{
+	public:
+		EventLogException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
+		const char* what() const throw()
+		{
+			return m_message.data();
+		}
+	private:
+		std::string m_message;
+};
+
+class DeckException : public std::exception
+{
+	public:
+		DeckException(const std::string& message) :
+			m_message(message)
+		{
+
+		}
+
 		const char* what() const throw()
 		{
 			return m_message.data();
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Latch.h"
+
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class EventLoop;
+
+/*
+	Fixed-size work-stealing executor. Every worker owns a deque: it pops its own work
+	from the back and, when empty, steals from the front of the other workers' deques.
+	Idle workers park on the pending task counter instead of a condition variable.
+	Destroying the executor runs every queued task before the workers are joined.
+*/
+class Executor
+{
+	using ExecutorTask = std::function<void()>;
+	using IndexedTask = std::function<void(int)>;
+
+	public:
+		class OffloadAwaiter
+		{
+			public:
+				OffloadAwaiter(Executor& executor, EventLoop& loop, ExecutorTask work) :
+					executor{ executor },
+					loop{ loop },
+					work{ std::move(work) }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return false; }
+				void await_suspend(std::coroutine_handle<> coroutine);
+				void await_resume() const
+				{
+					if (exception)
+					{
+						std::rethrow_exception(exception);
+					}
+				}
+			private:
+				Executor& executor;
+				EventLoop& loop;
+				ExecutorTask work;
+				std::exception_ptr exception;
+		};
+
+		Executor(int numOfWorkers = std::thread::hardware_concurrency());
+		~Executor();
+
+		Executor(const Executor&) = delete;
+		Executor& operator=(const Executor&) = delete;
+
+		void submit(ExecutorTask task);
+
+		// runs task(0) ... task(count - 1) as separate tasks and returns once all of them finished,
+		// the caller working through queued tasks meanwhile, so it may be called from a task as well
+		void forEach(int count, const IndexedTask& task);
+
+		// co_await runs work on a worker and resumes the awaiting coroutine back on loop
+		inline OffloadAwaiter offload(EventLoop& loop, ExecutorTask work) { return OffloadAwaiter(*this, loop, std::move(work)); }
+
+		inline int getNumOfWorkers() const { return workers.size(); }
+	private:
+		class WorkerQueue
+		{
+			public:
+				std::mutex mutex;
+				std::deque<ExecutorTask> tasks;
+		};
+
+		void workerLoop(int workerIndex);
+		// runs one queued task on the calling thread, false when none was found
+		bool runPendingTask();
+		bool popTask(int workerIndex, ExecutorTask& task);
+		bool stealTask(int workerIndex, ExecutorTask& task);
+
+		std::vector<std::unique_ptr<WorkerQueue>> queues;
+		std::vector<std::thread> workers;
+
+		std::atomic<bool> running;
+		std::atomic<int> pendingTasks;
+		std::atomic<unsigned int> nextQueue;
+};
\ No newline at end of file
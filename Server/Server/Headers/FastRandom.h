@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/*
+	SplitMix64: a handful of arithmetic operations per number and eight bytes of state, enough
+	to shuffle a table's submissions and play for absent players every round. Seeded from the
+	game seed and the round, so a round's draws can be reproduced; not meant for secrets.
+*/
+class FastRandom
+{
+	public:
+		using result_type = std::uint64_t;
+
+		FastRandom(std::uint64_t seed = 0) :
+			state{ seed }
+		{
+
+		}
+
+		// one stream per round of a game
+		inline void seed(unsigned int gameSeed, int round) { state = (static_cast<std::uint64_t>(gameSeed) << 32) | static_cast<unsigned int>(round); }
+
+		result_type operator()()
+		{
+			std::uint64_t mixed = (state += 0x9E3779B97F4A7C15ull);
+			mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+			mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+			return mixed ^ (mixed >> 31);
+		}
+
+		// uniform in [0, bound) with a multiplication instead of a division; the rare low
+		// products that would bias the result are drawn again
+		int nextBelow(int bound)
+		{
+			std::uint32_t range = bound;
+			std::uint64_t product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)())) * range;
+			if (static_cast<std::uint32_t>(product) < range)
+			{
+				std::uint32_t threshold = (0u - range) % range;
+				while (static_cast<std::uint32_t>(product) < threshold)
+				{
+					product = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)())) * range;
+				}
+			}
+			return product >> 32;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+	private:
+		std::uint64_t state;
+};
\ No newline at end of file
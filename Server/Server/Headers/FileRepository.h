@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Repository.h"
+#include "TextArena.h"
 
 #include <algorithm>
 #include <fstream>
@@ -27,15 +28,15 @@ class FileRepository : public Repository<T>
 	private:
 		void loadObjectsFromFile()
 		{
-			std::ifstream inputFile(filepath);
+			text.load(filepath);
 			T object;
-			while (inputFile >> object)
+			while (text >> object)
 			{
 				objects.emplace_back(object);
 			}
-			inputFile.close();
 		}
 
 		std::string filepath;
+		TextArena text;
 		std::vector<T> objects;
 };
\ No newline at end of file
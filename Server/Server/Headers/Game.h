@@ -4,14 +4,17 @@
 #include "Prompt.h"
 #include "StatementCard.h"
 #include "GameDataManager.h"
+#include "Snapshot.h"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <ctime>
 
 using PlayerIndex = int;
-using StatementText = std::string;
+using StatementText = std::string_view; // points into the statement card repository
 
 class GameConfiguration
 {
@@ -39,11 +42,16 @@ class GameState
 		GameState(const GameConfiguration& configuration)
 		{
 			statementCards.resize(configuration.numOfPlayers);
+			statementCardIds.resize(configuration.numOfPlayers);
 			usedStatementCards.resize(configuration.numOfPlayers);
 			for (auto& playerStatementCards : statementCards)
 			{
 				playerStatementCards.resize(configuration.numOfStatementCards);
 			}
+			for (auto& playerStatementCardIds : statementCardIds)
+			{
+				playerStatementCardIds.resize(configuration.numOfStatementCards);
+			}
 			for (auto& playerStatementCards : usedStatementCards)
 			{
 				playerStatementCards.resize(configuration.numOfStatementCards);
@@ -52,21 +60,28 @@ class GameState
 		}
 
 		int currentTsarIndex;
+		int currentPromptId;
 		Prompt currentPrompt;
 		std::vector<std::vector<StatementText>> statementCards;
+		// repository indices of the cards in statementCards, for the event log
+		std::vector<std::vector<int>> statementCardIds;
 		std::vector<std::vector<bool>> usedStatementCards;
 };
 
 class Game
 {
 	public:
-		Game(std::unique_ptr<Repository<Prompt>> promptRepository,
-			 std::unique_ptr<Repository<StatementCard>> statementCardRepository,
+		Game(std::shared_ptr<Repository<Prompt>> promptRepository,
+			 std::shared_ptr<Repository<StatementCard>> statementCardRepository,
 			 std::unique_ptr<GameDataManager> dataManager,
 			 const GameConfiguration& configuration);
 
 		void generateRoundData();
 
+		// the configuration is not part of the snapshot, restoring checks it matches instead
+		void saveState(SnapshotWriter& writer) const;
+		void restoreState(SnapshotReader& reader);
+
 		inline void setNumOfRounds(int numOfRounds) 
 		{
 			configuration.numOfRounds = numOfRounds;
@@ -101,9 +116,22 @@ class Game
 		{
 			return state.statementCards[playerIndex]; 
 		}
+
+		inline const std::vector<int>& getStatementCardIdsOfPlayer(int playerIndex) const
+		{
+			return state.statementCardIds[playerIndex];
+		}
+
+		inline StatementText getStatementCardText(int cardId) const
+		{
+			return statementCardRepository->getObject(cardId).text;
+		}
 	private:
-		std::unique_ptr<Repository<Prompt>> promptRepository;
-		std::unique_ptr<Repository<StatementCard>> statementCardRepository;
+		template<typename T>
+		static std::string_view restoreText(Repository<T>& repository, int id, const std::string& savedText);
+
+		std::shared_ptr<Repository<Prompt>> promptRepository;
+		std::shared_ptr<Repository<StatementCard>> statementCardRepository;
 		std::unique_ptr<GameDataManager> dataManager;
 		GameConfiguration configuration;
 		GameState state;
@@ -1,12 +1,15 @@
 #pragma once
 
+#include "Exceptions.h"
 #include "GeneratorStrategy.h"
 #include "Repository.h"
+#include "Snapshot.h"
 
 #include <algorithm>
 #include <map>
+#include <string>
 #include <memory>
-#include <set>
+#include <vector>
 
 class GameDataManager
 {
@@ -19,23 +22,28 @@ class GameDataManager
 
 		void addRepository(std::string associatedRepositoryName)
 		{
-			usedIndices[associatedRepositoryName] = std::set<int>();
+			usedIndices[associatedRepositoryName] = UsedIndices();
 		}
 
 		int generateUniqueRepositoryIndex(std::string associatedRepositoryName, int repositorySize)
 		{
-			if (usedIndices[associatedRepositoryName].size() == repositorySize)
+			UsedIndices& repositoryIndices = usedIndices[associatedRepositoryName];
+			if (repositoryIndices.count >= repositorySize)
 			{
-				// throw exception
+				throw DeckException("The " + associatedRepositoryName + " deck ran out of unused cards.");
+			}
+			// sized once per game, marking a card as dealt doesn't allocate afterwards
+			if (repositoryIndices.flags.size() < repositorySize)
+			{
+				repositoryIndices.flags.resize(repositorySize);
 			}
 			int index = indexGenerator->generateIntInRange(0, repositorySize);
-			auto found = std::find(usedIndices[associatedRepositoryName].begin(), usedIndices[associatedRepositoryName].end(), index);
-			while (found != usedIndices[associatedRepositoryName].end())
+			while (repositoryIndices.flags[index])
 			{
-				int index = indexGenerator->generateIntInRange(0, repositorySize);
-				found = std::find(usedIndices[associatedRepositoryName].begin(), usedIndices[associatedRepositoryName].end(), index);
+				index = indexGenerator->generateIntInRange(0, repositorySize);
 			}
-			usedIndices[associatedRepositoryName].emplace(index);
+			repositoryIndices.flags[index] = true;
+			repositoryIndices.count++;
 			return index;
 		}
 
@@ -43,8 +51,59 @@ class GameDataManager
 		{
 			return indexGenerator->generateIntInRange(0, numOfPlayers);
 		}
+
+		void saveState(SnapshotWriter& writer) const
+		{
+			writer.writeInt(usedIndices.size());
+			for (auto& repository : usedIndices)
+			{
+				writer.writeString(repository.first);
+				writer.writeInt(repository.second.count);
+				for (int index = 0; index < repository.second.flags.size(); index++)
+				{
+					if (repository.second.flags[index])
+					{
+						writer.writeInt(index);
+					}
+				}
+			}
+			indexGenerator->saveState(writer);
+		}
+
+		void restoreState(SnapshotReader& reader)
+		{
+			usedIndices.clear();
+			int numOfRepositories = reader.readCount();
+			for (int i = 0; i < numOfRepositories; i++)
+			{
+				UsedIndices& indices = usedIndices[reader.readString()];
+				int numOfIndices = reader.readCount();
+				for (int j = 0; j < numOfIndices; j++)
+				{
+					int index = reader.readInt();
+					if (index < 0)
+					{
+						throw SnapshotException("Corrupt snapshot.");
+					}
+					if (index >= indices.flags.size())
+					{
+						indices.flags.resize(index + 1);
+					}
+					indices.count += !indices.flags[index];
+					indices.flags[index] = true;
+				}
+			}
+			indexGenerator->restoreState(reader);
+		}
 	private:
+		class UsedIndices
+		{
+			public:
+				std::vector<bool> flags;
+				int count = 0;
+		};
+
 		std::unique_ptr<GeneratorStrategy> indexGenerator;
 
-		std::map<std::string, std::set<int>> usedIndices; 
+		std::map<std::string, UsedIndices> usedIndices; 
 };
\ No newline at end of file
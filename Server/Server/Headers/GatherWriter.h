@@ -0,0 +1,72 @@
+#pragma once
+
+#include "WNetwok.h"
+
+#include <deque>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace gather
+{
+	// holds the integers and buffer list of a usual hand or player list, larger messages spill to the heap
+	const int INLINE_BYTES = 1536;
+	const int EXPECTED_BUFFERS = 32;
+}
+
+/*
+	Multi-part message kept as a list of buffers instead of being copied together. Integers are
+	stored in the writer itself, strings are only referenced, so card texts go out straight from
+	the deck's memory; consecutive integers share one buffer. Referenced text has to outlive the
+	send.
+*/
+class GatherWriter
+{
+	public:
+		GatherWriter() :
+			memory{ storage, sizeof(storage) },
+			headers{ &memory },
+			buffers{ &memory },
+			lastIsHeader{ false }
+		{
+			buffers.reserve(gather::EXPECTED_BUFFERS);
+		}
+
+		GatherWriter(const GatherWriter&) = delete;
+		GatherWriter& operator=(const GatherWriter&) = delete;
+
+		void writeInt(int value)
+		{
+			// a deque never moves its elements, so buffers can point into it
+			char* bytes = reinterpret_cast<char*>(&headers.emplace_back(value));
+			if (lastIsHeader && buffers.back().buf + buffers.back().len == bytes)
+			{
+				buffers.back().len += sizeof(int);
+			}
+			else
+			{
+				buffers.emplace_back(WSABUF{ sizeof(int), bytes });
+			}
+			lastIsHeader = true;
+		}
+
+		void writeString(std::string_view text)
+		{
+			writeInt(text.length());
+			if (!text.empty())
+			{
+				// only ever read from, WSABUF just has no const version
+				buffers.emplace_back(WSABUF{ static_cast<ULONG>(text.length()), const_cast<char*>(text.data()) });
+				lastIsHeader = false;
+			}
+		}
+
+		inline const WSABUF* getBuffers() const { return buffers.data(); }
+		inline int getNumOfBuffers() const { return buffers.size(); }
+	private:
+		char storage[gather::INLINE_BYTES];
+		std::pmr::monotonic_buffer_resource memory;
+		std::pmr::deque<int> headers;
+		std::pmr::vector<WSABUF> buffers;
+		bool lastIsHeader;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Prompt.h"
+#include "Repository.h"
+#include "StatementCard.h"
+
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+	Cards made up in memory, so benchmarks and tests don't depend on the deck files at hand.
+	Every card is numbered and prompts have a single blank.
+*/
+template<typename T>
+class GeneratedRepository : public Repository<T>
+{
+	public:
+		GeneratedRepository(int size)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				texts.emplace_back("Generated card #" + std::to_string(i));
+			}
+			for (auto& text : texts)
+			{
+				if constexpr (std::is_same_v<T, Prompt>)
+				{
+					objects.emplace_back(text, 1);
+				}
+				else
+				{
+					objects.emplace_back(text);
+				}
+			}
+		}
+
+		virtual const T& getObject(int index) const override { return objects[index]; }
+		virtual int size() override { return objects.size(); }
+	private:
+		std::deque<std::string> texts;
+		std::vector<T> objects;
+};
\ No newline at end of file
@@ -1,7 +1,14 @@
 #pragma once
 
+class SnapshotReader;
+class SnapshotWriter;
+
 class GeneratorStrategy
 {
 	public:
 		virtual int generateIntInRange(int minValue, int maxValue) = 0;
+
+		// generators whose state can't be captured (like the global rand()) keep these empty
+		virtual void saveState(SnapshotWriter&) const { }
+		virtual void restoreState(SnapshotReader&) { }
 };
\ No newline at end of file
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "Exceptions.h"
+#include "Protocol.h"
+#include "TimerWheel.h"
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+namespace inbox
+{
+	// payload buffers kept for reuse; more than a round's worth would only hold on to memory
+	const int MAX_SPARE_BUFFERS = 4;
+	// a round asks a client for a couple of replies; a backlog this long is a client flooding the server
+	const int MAX_QUEUED_MESSAGES = 16;
+}
+
+/*
+	Messages read from one client, waiting for the phase that consumes them. A phase asks for
+	a (round, type) pair: anything older is a late reply to a closed phase and is dropped,
+	anything newer stays queued until its phase comes, up to a cap past which the client is
+	dropped. Waiting is bounded by a deadline on the loop's timer wheel.
+*/
+class Inbox
+{
+	public:
+		class Awaiter
+		{
+			public:
+				Awaiter(Inbox& inbox, MessageType type, int round, std::chrono::milliseconds timeout) :
+					inbox{ inbox },
+					type{ type },
+					round{ round },
+					timeout{ timeout }
+				{
+
+				}
+
+				bool await_ready() { return inbox.take(type, round, message) || inbox.closed; }
+
+				void await_suspend(std::coroutine_handle<> coroutine)
+				{
+					this->coroutine = coroutine;
+					inbox.waiter = this;
+					if (timeout.count() > 0)
+					{
+						deadline.callback = [this]{ inbox.wake(); };
+						inbox.loop.timers().schedule(deadline, timeout);
+					}
+				}
+
+				// empty when the deadline passed or the client disconnected
+				std::optional<Message> await_resume()
+				{
+					deadline.cancel();
+					return std::move(message);
+				}
+			private:
+				friend class Inbox;
+
+				Inbox& inbox;
+				MessageType type;
+				int round;
+				std::chrono::milliseconds timeout;
+				std::optional<Message> message;
+				std::coroutine_handle<> coroutine;
+				Timer deadline;
+		};
+
+		Inbox(EventLoop& loop) :
+			loop{ loop },
+			closed{ false },
+			messages{ loop.memory() },
+			waiter{ nullptr }
+		{
+			spareBuffers.reserve(inbox::MAX_SPARE_BUFFERS);
+		}
+
+		Inbox(const Inbox&) = delete;
+		Inbox& operator=(const Inbox&) = delete;
+
+		void push(Message message)
+		{
+			if (messages.size() >= inbox::MAX_QUEUED_MESSAGES)
+			{
+				throw ConnectionException("Too many messages ahead of the game.");
+			}
+			messages.emplace_back(std::move(message));
+			if (waiter && take(waiter->type, waiter->round, waiter->message))
+			{
+				wake();
+			}
+		}
+
+		void close()
+		{
+			closed = true;
+			messages.clear();
+			wake();
+		}
+
+		// a resumed session gets a fresh start on the new connection
+		void reopen()
+		{
+			closed = false;
+			messages.clear();
+		}
+
+		Awaiter receive(MessageType type, int round, std::chrono::milliseconds timeout)
+		{
+			return Awaiter(*this, type, round, timeout);
+		}
+
+		// the reader fills a consumed message's buffer again instead of allocating a new one
+		std::vector<char> takeBuffer()
+		{
+			if (spareBuffers.empty())
+			{
+				return std::vector<char>();
+			}
+			std::vector<char> buffer = std::move(spareBuffers.back());
+			spareBuffers.pop_back();
+			return buffer;
+		}
+
+		void recycle(Message message)
+		{
+			if (spareBuffers.size() < inbox::MAX_SPARE_BUFFERS)
+			{
+				message.payload.clear();
+				spareBuffers.emplace_back(std::move(message.payload));
+			}
+		}
+
+		inline bool isClosed() const { return closed; }
+	private:
+		bool take(MessageType type, int round, std::optional<Message>& message)
+		{
+			while (!messages.empty() && isBefore(messages.front(), type, round))
+			{
+				recycle(std::move(messages.front()));
+				messages.pop_front();
+			}
+			if (!messages.empty() && messages.front().round == round && messages.front().type == type)
+			{
+				message = std::move(messages.front());
+				messages.pop_front();
+				return true;
+			}
+			return false;
+		}
+
+		void wake()
+		{
+			if (waiter)
+			{
+				loop.schedule(waiter->coroutine);
+				waiter = nullptr;
+			}
+		}
+
+		static bool isBefore(const Message& message, MessageType type, int round)
+		{
+			return message.round < round || (message.round == round && message.type < type);
+		}
+
+		EventLoop& loop;
+		bool closed;
+		std::pmr::deque<Message> messages;
+		Awaiter* waiter;
+		std::vector<std::vector<char>> spareBuffers;
+};
\ No newline at end of file
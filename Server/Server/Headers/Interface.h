@@ -3,10 +3,12 @@
 #include "Command.h"
 #include "Server.h"
 
+#include <initializer_list>
 #include <istream>
 #include <map>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Interface
@@ -18,6 +20,8 @@ class Interface
 
 		void run();
 		void printMessage(const std::string& message);
+		// prints the parts as one line without joining them into a string first
+		void printMessage(std::initializer_list<std::string_view> parts);
 	private:
 		void setupCommands();
 
@@ -28,6 +32,9 @@ class Interface
 		void exit(const std::vector<std::string>& arguments);
 		void echo(const std::vector<std::string>& arguments);
 		void startServer(const std::vector<std::string>& arguments);
+		void replayEventLog(const std::vector<std::string>& arguments);
+		void analyzeEventLog(const std::vector<std::string>& arguments);
+		void runBenchmark(const std::vector<std::string>& arguments);
 
 		bool isInputEmpty(const std::string& input);
 
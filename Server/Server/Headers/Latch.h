@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace latch
+{
+	// number of times a waiter re-checks the state before parking on the atomic
+	const int SPIN_COUNT = 64;
+}
+
+/*
+	Single-use countdown latch (std::latch semantics) that can be re-armed between rounds.
+	Waiters spin briefly and then park on the counter itself (std::atomic::wait), so
+	no mutex is ever held by a waiting thread.
+*/
+class Latch
+{
+	public:
+		Latch(int expected = 1) :
+			expected{ expected },
+			remaining{ expected }
+		{
+
+		}
+
+		Latch(const Latch&) = delete;
+		Latch& operator=(const Latch&) = delete;
+
+		void setExpected(int expected)
+		{
+			this->expected = expected;
+			remaining.store(expected, std::memory_order_release);
+		}
+
+		void countDown()
+		{
+			if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				remaining.notify_all();
+			}
+		}
+
+		void wait() const
+		{
+			int spins = 0;
+			int current = remaining.load(std::memory_order_acquire);
+			while (current > 0)
+			{
+				if (spins < latch::SPIN_COUNT)
+				{
+					spins++;
+					std::this_thread::yield();
+				}
+				else
+				{
+					remaining.wait(current, std::memory_order_acquire);
+				}
+				current = remaining.load(std::memory_order_acquire);
+			}
+		}
+
+		inline bool ready() const { return remaining.load(std::memory_order_acquire) <= 0; }
+
+		// only valid once every participant of the previous phase has passed wait()
+		inline void reset() { remaining.store(expected, std::memory_order_release); }
+	private:
+		int expected;
+		std::atomic<int> remaining;
+};
+
+/*
+	Reusable phase barrier (std::barrier semantics, without a completion function). The last
+	thread to arrive releases every participant into the next phase.
+*/
+class Barrier
+{
+	public:
+		Barrier(int participants = 1) :
+			participants{ participants },
+			arrived{ 0 },
+			generation{ 0 }
+		{
+
+		}
+
+		Barrier(const Barrier&) = delete;
+		Barrier& operator=(const Barrier&) = delete;
+
+		void setParticipants(int participants) { this->participants = participants; }
+
+		void arriveAndWait()
+		{
+			int currentGeneration = generation.load(std::memory_order_acquire);
+			if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == participants)
+			{
+				arrived.store(0, std::memory_order_relaxed);
+				generation.fetch_add(1, std::memory_order_release);
+				generation.notify_all();
+				return;
+			}
+			int spins = 0;
+			while (generation.load(std::memory_order_acquire) == currentGeneration)
+			{
+				if (spins < latch::SPIN_COUNT)
+				{
+					spins++;
+					std::this_thread::yield();
+				}
+				else
+				{
+					generation.wait(currentGeneration, std::memory_order_acquire);
+				}
+			}
+		}
+	private:
+		int participants;
+		std::atomic<int> arrived;
+		std::atomic<int> generation;
+};
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Client.h"
+#include "EventLoop.h"
+#include "TimerWheel.h"
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace lobby
+{
+	// a lobby that expires with at least this many players starts a smaller table instead of sending them home
+	const int MIN_PLAYERS = 3;
+	// how long such a smaller table keeps its open seats for latecomers before it is dealt
+	const int FILL_TIMEOUT_MILLISECONDS = 10000;
+}
+
+/*
+	Players waiting for a table. Joiners queue in arrival order and a table is formed as soon as
+	a full table's worth of them is waiting. When the longest waiting player's timeout runs out
+	with at least the minimum number waiting, they are seated at a partial table instead, which
+	keeps its open seats for a while before it is dealt; if players leave it until fewer than the
+	minimum are left, those queue again instead. Partial tables are bucketed by their
+	number of open seats and a joiner takes a seat at the fullest one, so joining, leaving and
+	forming a table take the same time however many players are waiting.
+*/
+class Lobby
+{
+	public:
+		using Players = std::vector<std::shared_ptr<Client>>;
+
+		Lobby(EventLoop& loop, int numOfPlayers, int minNumOfPlayers, std::chrono::milliseconds timeout);
+
+		Lobby(const Lobby&) = delete;
+		Lobby& operator=(const Lobby&) = delete;
+
+		inline void open() { opened = true; }
+		// turns later joiners away and hands back everyone still waiting
+		Players close();
+
+		void join(std::shared_ptr<Client> client);
+		// false when the player isn't waiting here, it was dealt in or sent home already
+		bool leave(const Client& client);
+
+		inline bool isOpen() const { return opened; }
+		inline bool contains(const Client& client) const { return seats.find(&client) != seats.end(); }
+		inline bool isEmpty() const { return seats.empty(); }
+
+		// the players of a table that is ready to be dealt
+		std::function<void(Players)> onTableFormed;
+		// players whose timeout ran out while too few others were waiting to start a table
+		std::function<void(Players)> onExpired;
+	private:
+		class Waiting
+		{
+			public:
+				std::shared_ptr<Client> client;
+				TimerWheel::Clock::time_point since;
+		};
+
+		class PartialTable;
+		using Bucket = std::list<std::unique_ptr<PartialTable>>;
+
+		class PartialTable
+		{
+			public:
+				Players players;
+				int bucket;
+				Bucket::iterator position;
+				Timer fillDeadline;
+		};
+
+		// where a waiting player is: in the queue, or at a partial table
+		class Seat
+		{
+			public:
+				std::list<Waiting>::iterator queued;
+				PartialTable* table;
+		};
+
+		void formTable();
+		void expire();
+		void armDeadline();
+		void sit(PartialTable& table, std::shared_ptr<Client> client);
+		void moveToBucket(PartialTable& table);
+		void deal(PartialTable& table);
+		void requeue(PartialTable& table);
+		void retire(PartialTable& table);
+		inline int getOpenSeats(const PartialTable& table) const { return numOfPlayers - table.players.size(); }
+
+		EventLoop& loop;
+		int numOfPlayers;
+		int minNumOfPlayers;
+		std::chrono::milliseconds timeout;
+		bool opened;
+		std::list<Waiting> queue;
+		// partialTables[n] holds the partial tables with n open seats
+		std::vector<Bucket> partialTables;
+		// the partial table dealt or given up last; it is freed with the next one, not from its own deadline
+		std::unique_ptr<PartialTable> retiredTable;
+		std::unordered_map<const Client*, Seat> seats;
+		// runs out when the head of the queue has waited for the whole timeout
+		Timer deadline;
+};
\ No newline at end of file
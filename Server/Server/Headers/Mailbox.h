@@ -0,0 +1,141 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "SpscQueue.h"
+#include "TimerWheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+
+namespace mailbox
+{
+	// how soon a sender whose queue was full tries the messages it kept back again
+	const int RETRY_MILLISECONDS = 10;
+}
+
+/*
+	Wakes a loop's receiving coroutine when another thread left it something. The receiver
+	parks only after it took everything, a sender rings after it queued; whichever of the two
+	comes second finds the other's mark, so a message is never left unnoticed and the parked
+	coroutine is posted to its loop at most once per ring.
+*/
+class Doorbell
+{
+	public:
+		class Awaiter
+		{
+			public:
+				Awaiter(Doorbell& doorbell) :
+					doorbell{ doorbell }
+				{
+
+				}
+
+				bool await_ready() { return doorbell.rung.exchange(false); }
+
+				bool await_suspend(std::coroutine_handle<> coroutine)
+				{
+					doorbell.sleeper.store(coroutine.address());
+					if (!doorbell.rung.exchange(false))
+					{
+						return true;
+					}
+					// rung in between; resumes right away unless the ringer already took the coroutine to post it
+					return doorbell.sleeper.exchange(nullptr) == nullptr;
+				}
+
+				void await_resume() const noexcept { }
+			private:
+				Doorbell& doorbell;
+		};
+
+		Doorbell(EventLoop& loop) :
+			loop{ loop },
+			rung{ false },
+			sleeper{ nullptr }
+		{
+
+		}
+
+		Doorbell(const Doorbell&) = delete;
+		Doorbell& operator=(const Doorbell&) = delete;
+
+		// any thread
+		void ring()
+		{
+			rung.store(true);
+			if (void* coroutine = sleeper.exchange(nullptr))
+			{
+				loop.post(std::coroutine_handle<>::from_address(coroutine));
+			}
+		}
+
+		// the receiving loop's thread, after it took everything it was sent
+		Awaiter wait() { return Awaiter(*this); }
+	private:
+		EventLoop& loop;
+		std::atomic<bool> rung;
+		std::atomic<void*> sleeper;
+};
+
+/*
+	One direction between the loops of two threads: a SpscQueue and the receiver's doorbell.
+	A message that doesn't fit stays with the sender and is queued with its next message, or
+	after RETRY_MILLISECONDS on the sender's loop when nothing follows, so neither side ever
+	blocks on the other.
+*/
+template <typename T>
+class Mailbox
+{
+	public:
+		Mailbox(EventLoop& senderLoop, Doorbell& receiver, std::size_t capacity) :
+			senderLoop{ senderLoop },
+			receiver{ receiver },
+			queue(capacity)
+		{
+			retry.callback = [this]{ flushHeldBack(); };
+		}
+
+		Mailbox(const Mailbox&) = delete;
+		Mailbox& operator=(const Mailbox&) = delete;
+
+		// sender's thread
+		void send(T message)
+		{
+			heldBack.emplace_back(std::move(message));
+			flushHeldBack();
+		}
+
+		// receiver's thread
+		inline bool receive(T& message) { return queue.tryPop(message); }
+
+		// sender's thread; kept back messages are only sent while the sender's loop runs
+		inline bool hasHeldBack() const { return !heldBack.empty(); }
+	private:
+		void flushHeldBack()
+		{
+			bool sent = false;
+			while (!heldBack.empty() && queue.tryPush(std::move(heldBack.front())))
+			{
+				heldBack.pop_front();
+				sent = true;
+			}
+			if (sent)
+			{
+				receiver.ring();
+			}
+			if (!heldBack.empty() && !retry.isScheduled())
+			{
+				senderLoop.timers().schedule(retry, std::chrono::milliseconds(mailbox::RETRY_MILLISECONDS));
+			}
+		}
+
+		EventLoop& senderLoop;
+		Doorbell& receiver;
+		SpscQueue<T> queue;
+		std::deque<T> heldBack;
+		Timer retry;
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "EventLoop.h"
+
+#include <coroutine>
+#include <functional>
+#include <vector>
+
+/*
+	Awaitable counterpart of Latch for coroutines running on one EventLoop: co_await
+	suspends until countDown() was called the expected number of times. Not thread-safe.
+*/
+class PhaseEvent
+{
+	public:
+		class Awaiter
+		{
+			public:
+				Awaiter(PhaseEvent& event) :
+					event{ event }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return event.ready(); }
+				void await_suspend(std::coroutine_handle<> coroutine) { event.waiters.emplace_back(coroutine); }
+				void await_resume() const noexcept { }
+			private:
+				PhaseEvent& event;
+		};
+
+		PhaseEvent(EventLoop& loop, int expected = 1) :
+			loop{ loop },
+			expected{ expected },
+			remaining{ expected }
+		{
+
+		}
+
+		PhaseEvent(const PhaseEvent&) = delete;
+		PhaseEvent& operator=(const PhaseEvent&) = delete;
+
+		void setExpected(int expected)
+		{
+			this->expected = expected;
+			remaining = expected;
+		}
+
+		void countDown()
+		{
+			if (--remaining == 0)
+			{
+				for (auto& waiter : waiters)
+				{
+					loop.schedule(waiter);
+				}
+				waiters.clear();
+			}
+		}
+
+		inline bool ready() const { return remaining <= 0; }
+		inline void reset() { remaining = expected; }
+
+		Awaiter operator co_await() { return Awaiter(*this); }
+	private:
+		EventLoop& loop;
+		int expected;
+		int remaining;
+		std::vector<std::coroutine_handle<>> waiters;
+};
+
+/*
+	Awaitable counterpart of Barrier for the loop: the last participant to arrive runs the completion
+	function and releases everyone into the next phase.
+*/
+class PhaseBarrier
+{
+	using CompletionFunction = std::function<void()>;
+
+	public:
+		class Awaiter
+		{
+			public:
+				Awaiter(PhaseBarrier& barrier) :
+					barrier{ barrier }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return false; }
+				bool await_suspend(std::coroutine_handle<> coroutine) { return barrier.arrive(coroutine); }
+				void await_resume() const noexcept { }
+			private:
+				PhaseBarrier& barrier;
+		};
+
+		PhaseBarrier(EventLoop& loop, int participants = 1, const CompletionFunction& completion = CompletionFunction()) :
+			loop{ loop },
+			participants{ participants },
+			completion{ completion }
+		{
+
+		}
+
+		PhaseBarrier(const PhaseBarrier&) = delete;
+		PhaseBarrier& operator=(const PhaseBarrier&) = delete;
+
+		void setParticipants(int participants) { this->participants = participants; }
+		void setCompletion(const CompletionFunction& completion) { this->completion = completion; }
+
+		Awaiter arriveAndWait() { return Awaiter(*this); }
+	private:
+		// returns false for the last participant, which carries on without suspending
+		bool arrive(std::coroutine_handle<> coroutine)
+		{
+			if (waiters.size() + 1 < participants)
+			{
+				waiters.emplace_back(coroutine);
+				return true;
+			}
+			if (completion)
+			{
+				completion();
+			}
+			for (auto& waiter : waiters)
+			{
+				loop.schedule(waiter);
+			}
+			waiters.clear();
+			return false;
+		}
+
+		EventLoop& loop;
+		int participants;
+		CompletionFunction completion;
+		std::vector<std::coroutine_handle<>> waiters;
+};
\ No newline at end of file
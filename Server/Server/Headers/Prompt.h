@@ -1,26 +1,36 @@
 #pragma once
 
+#include "TextArena.h"
+
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <iostream>
 
+namespace prompt
+{
+	// submissions are stored in fixed-size rows, prompts asking for more cards are capped
+	const int MAX_BLANKS = 3;
+}
+
 class Prompt
 {
 	public:
 		Prompt() = default;
-		Prompt(const std::string& text, int numOfBlanks) :
+		Prompt(std::string_view text, int numOfBlanks) :
 			text{ text },
 			numOfBlanks{ numOfBlanks }
 		{
 
 		}
 
-		inline friend std::istream& operator>>(std::istream& inputStream, Prompt& prompt)
+		inline friend TextArena& operator>>(TextArena& arena, Prompt& prompt)
 		{
-			std::string numOfBlanks;
-			std::getline(inputStream, prompt.text);
-			std::getline(inputStream, numOfBlanks);
-			prompt.numOfBlanks = atoi(numOfBlanks.c_str());
-			return inputStream;
+			std::string_view numOfBlanks;
+			arena.readLine(prompt.text);
+			arena.readLine(numOfBlanks);
+			prompt.numOfBlanks = std::min(atoi(std::string(numOfBlanks).c_str()), prompt::MAX_BLANKS);
+			return arena;
 		}
 
 		inline friend std::ostream& operator<<(std::ostream& outputStream, const Prompt& prompt)
@@ -30,6 +40,6 @@ class Prompt
 			return outputStream;
 		}
 
-		std::string text;
+		std::string_view text; // points into the deck's arena
 		int numOfBlanks;
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Deck.h"
+#include "Game.h"
+#include "Snapshot.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Interface;
+
+namespace replay
+{
+	// past this many the rest are only counted
+	const int MAX_REPORTED_DIVERGENCES = 10;
+}
+
+/*
+	Plays an event log back against the game model. Every game is rebuilt from its seed and
+	decks, each dealt round is checked against what generateRoundData produces now, and the
+	logged submissions and verdicts are applied so the final scores can be compared as well.
+	Games played side by side are followed at once, each by the table its events came from.
+*/
+class Replay
+{
+	public:
+		Replay(Interface& userInterface);
+
+		void run(const std::string& eventLogFilepath);
+	private:
+		class ReplayedGame
+		{
+			public:
+				// counted from the start of the log, as the game is reported
+				int number;
+				std::unique_ptr<Game> game;
+				std::vector<int> scores;
+				bool skipping;
+		};
+
+		void startGame(ReplayedGame& game, SnapshotReader& event);
+		void checkRoundDealt(ReplayedGame& game, SnapshotReader& event);
+		void applyCardsSubmitted(ReplayedGame& game, SnapshotReader& event);
+		void applyWinnerChosen(ReplayedGame& game, SnapshotReader& event);
+		void checkGameEnded(ReplayedGame& game, SnapshotReader& event);
+		void reportDivergence(const ReplayedGame& game, const std::string& description);
+
+		Interface& userInterface;
+
+		// decks are loaded once per path, games in the same log usually share them
+		std::map<std::pair<std::string, std::string>, std::shared_ptr<const Deck>> decks;
+
+		// the game each table is playing, by the table's number
+		std::map<int, ReplayedGame> games;
+		int numOfGames;
+		int numOfEvents;
+		int numOfDivergences;
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace roundarena
+{
+	// enough for the submissions of a full table; a round that needs more spills over to the heap
+	const int CAPACITY = 16 * 1024;
+}
+
+/*
+	Scratch memory of one table's round. Whatever the round builds up is carved out of a single
+	buffer with a bump pointer, and dropped all at once by reset() when the round ends, so
+	steady-state rounds don't go to the heap. Containers allocated from it must be emptied
+	before reset().
+*/
+class RoundArena
+{
+	public:
+		RoundArena(int capacity = roundarena::CAPACITY) :
+			buffer(capacity),
+			memory{ buffer.data(), buffer.size() }
+		{
+
+		}
+
+		RoundArena(const RoundArena&) = delete;
+		RoundArena& operator=(const RoundArena&) = delete;
+
+		inline std::pmr::memory_resource* resource() { return &memory; }
+		inline void reset() { memory.release(); }
+	private:
+		std::vector<std::byte> buffer;
+		std::pmr::monotonic_buffer_resource memory;
+};
\ No newline at end of file
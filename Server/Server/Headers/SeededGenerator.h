@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Exceptions.h"
+#include "GeneratorStrategy.h"
+#include "Snapshot.h"
+
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace generator
+{
+	// the engine's text at its longest: every word of its state and its position, with a space after each
+	const std::size_t MAX_STATE_TEXT_LENGTH = (std::mt19937::state_size + 1) * (std::numeric_limits<std::mt19937::result_type>::digits10 + 2);
+}
+
+/*
+	Generator with its own engine instead of the global rand() state, so the sequence can be
+	reproduced from a seed and carried across a restart in a snapshot.
+*/
+class SeededGenerator : public GeneratorStrategy
+{
+	public:
+		SeededGenerator(unsigned int seed) :
+			engine{ seed }
+		{
+
+		}
+
+		virtual int generateIntInRange(int minValue, int maxValue) override
+		{
+			if (maxValue <= minValue)
+			{
+				throw SeededGeneratorException("maxValue must exceed minValue.");
+			}
+			return std::uniform_int_distribution<int>(minValue, maxValue - 1)(engine);
+		}
+
+		virtual void saveState(SnapshotWriter& writer) const override
+		{
+			// the text is written into the buffer of the last checkpoint, which is taken back and emptied first;
+			// the length depends on the numbers drawn, so the buffer is made long enough for any of them once
+			std::string buffer = std::move(stateText).str();
+			buffer.clear();
+			buffer.reserve(generator::MAX_STATE_TEXT_LENGTH);
+			stateText.str(std::move(buffer));
+			stateText << engine;
+			writer.writeString(stateText.view());
+		}
+
+		virtual void restoreState(SnapshotReader& reader) override
+		{
+			std::istringstream state(reader.readString());
+			state >> engine;
+			if (!state)
+			{
+				throw SnapshotException("Corrupt generator state.");
+			}
+		}
+	private:
+		std::mt19937 engine;
+		mutable std::ostringstream stateText;
+};
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "EventLoop.h"
+#include "Task.h"
+#include "TimerWheel.h"
+#include "WNetwok.h"
+
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace sendqueue
+{
+	// senders wait once this much is queued and go on when it drained below the low watermark
+	const int HIGH_WATERMARK = 64 * 1024;
+	const int LOW_WATERMARK = 16 * 1024;
+	// a peer that keeps its queue over the high watermark this long is disconnected
+	const int STALL_TIMEOUT_MILLISECONDS = 10000;
+	// small sends share chunks of this size, so a message goes out as a handful of buffers
+	const int CHUNK_SIZE = 4096;
+	// buffers handed to a single WSASend, enough for a whole hand
+	const int MAX_BUFFERS_PER_SEND = 64;
+}
+
+/*
+	Outbound bytes of one connection. A send copies into the queue and returns at once, the
+	flusher writes everything queued with one WSASend per turn of the loop and waits for
+	writability whenever the socket is full. A gathered message is written immediately instead,
+	in one WSASend with whatever is queued ahead of it, and copied only as far as the socket
+	didn't take it. Past the high watermark senders are held back until
+	the queue drained to the low watermark, and a peer that stays over it for
+	STALL_TIMEOUT_MILLISECONDS is cut off instead of holding up whoever sends to it.
+	The flusher shares ownership of the queue, so it can finish after the connection is gone.
+*/
+class SendQueue : public std::enable_shared_from_this<SendQueue>
+{
+	public:
+		class SpaceAwaiter
+		{
+			public:
+				SpaceAwaiter(SendQueue& queue) :
+					queue{ queue }
+				{
+
+				}
+
+				// whoever already waits goes first, so buffers stay in the order they were sent
+				bool await_ready() const noexcept { return queue.closed || (queue.queuedBytes < queue.highWatermark && queue.blockedSenders.empty()); }
+				void await_suspend(std::coroutine_handle<> coroutine) { queue.blockedSenders.emplace_back(coroutine); }
+				void await_resume() const noexcept { }
+			private:
+				SendQueue& queue;
+		};
+
+		SendQueue(EventLoop& loop, SocketHandle handle);
+
+		SendQueue(const SendQueue&) = delete;
+		SendQueue& operator=(const SendQueue&) = delete;
+
+		SpaceAwaiter space() { return SpaceAwaiter(*this); }
+		void push(const void* data, int size);
+		// written right away together with what is queued, only what the socket doesn't take is copied
+		void push(const WSABUF* buffers, int numOfBuffers);
+
+		// drops whatever is still queued and closes the socket; safe to call more than once
+		void close(const std::string& reason);
+		void closeWhenSent();
+
+		void setWatermarks(int lowWatermark, int highWatermark);
+
+		inline bool isClosed() const { return closed; }
+		inline const std::string& getCloseReason() const { return closeReason; }
+		inline int getQueuedBytes() const { return queuedBytes; }
+		inline int getPeakQueuedBytes() const { return peakQueuedBytes; }
+		// times the queue went over the high watermark
+		inline int getNumOfStalls() const { return numOfStalls; }
+	private:
+		static Task flush(std::shared_ptr<SendQueue> queue);
+		void append(const char* data, int size);
+		// fills the batch with the queued chunks, returns how many buffers it used
+		int gatherQueued(WSABUF* batch);
+		void consume(int sent);
+		void wakeSenders();
+
+		EventLoop& loop;
+		SocketHandle handle;
+		bool closed;
+		bool flushing;
+		bool writeBlocked;
+		bool closing;
+		std::string closeReason;
+
+		std::pmr::deque<std::pmr::vector<char>> chunks;
+		// bytes of the front chunk already sent
+		int offset;
+		int queuedBytes;
+		int lowWatermark;
+		int highWatermark;
+		std::pmr::deque<std::coroutine_handle<>> blockedSenders;
+		Timer stallDeadline;
+
+		int peakQueuedBytes;
+		int numOfStalls;
+};
\ No newline at end of file
@@ -1,21 +1,49 @@
 #pragma once
 
 #include "Client.h"
-#include "CounterLock.h"
-#include "FlagLock.h"
+#include "DeckLibrary.h"
+#include "EventLog.h"
+#include "EventLoop.h"
+#include "Executor.h"
 #include "Game.h"
+#include "Lobby.h"
+#include "Mailbox.h"
+#include "Protocol.h"
+#include "Shard.h"
+#include "Snapshot.h"
+#include "Table.h"
+#include "Task.h"
+#include "TimeoutPolicy.h"
+#include "TimerWheel.h"
+#include "UsernameRegistry.h"
 #include "WNetwok.h"
 
-#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
-#include <string>
-#include <thread>
 #include <mutex>
-#include <condition_variable>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace acceptor
+{
+	// connections of a join storm wait in the kernel instead of being refused while the loop catches up
+	const int LISTEN_BACKLOG = SOMAXCONN;
+	// taken per wakeup of the listening socket before handshakes and timers get their turn
+	const int MAX_ACCEPTS_PER_WAKEUP = 64;
+}
 
 class Interface;
-class Game;
 
+/*
+	Accepts connections and reads their handshakes, then hands every player to one of its shards,
+	which plays the player's table on its own thread. The server keeps what has to be the same for
+	all of them: the names in use, which shard seats which session, the checkpoint and the event
+	log. Joiners are placed where a table is closest to being dealt, otherwise on the shard with
+	the fewest tables.
+*/
 class Server
 {
 	public:
@@ -24,97 +52,90 @@ class Server
 
 		void start();
 	private:
-		void loadSettings();
-
-		void acceptConnections();
-		void receiveUsernameFromClient(std::unique_ptr<Client>& client);
-		bool validUsername(std::unique_ptr<Client>& client);
+		// what the server knows of a shard from its reports
+		class ShardStatus
+		{
+			public:
+				// joiners handed to it that weren't dealt in or sent home yet
+				int waiting;
+				int numOfTables;
+				bool lobbyOpen;
+		};
 
-		std::vector<std::string> getPlayerList() const;
-		void sendPlayerIDToClient(int clientIndex);
-		void sendPlayerListToClient(int clientIndex);
-		void sendNumOfRoundsToClient(int clientIndex);
-		void sendNumOfStatementCardsToClient(int clientIndex);
-		void sendGeneratedTsarIndexToClient(int clientIndex);
-		void sendGeneratedPromptToClient(int clientIndex);
-		void sendGeneratedStatementCardsToClient(int clientIndex);
-		void sendStatementCardChoicesToClient(int clientIndex);
-		void sendTsarStatementCardChoiceToClient(int clientIndex);
-		void sendServerConfirmationToClient(int clientIndex);
-
-		void receiveStatementCardChoiceFromClient(int clientIndex);
-		void receiveStatementCardChoiceFromTsar(int clientIndex);
-		void receiveNextRoundConfirmationFromClient(int clientIndex);
-
-		void gameLogic();
-		void sendClient(int clientIndex);
-		void receiveClient(int clientIndex);
-		void resetData();
-
-		void generateData_();
-		void shuffleStatementCards_();
-		void resetData_();
-
-		void sendData_(int clientIndex);
-		void sendStatementCardChoices_(int clientIndex);
-		void sendTsarChoice_(int clientIndex);
-		void sendConfirmation_(int clientIndex);
-
-		void receiveData_(int clientIndex);
-		void receiveConfirmation_(int clientIndex);
+		void loadSettings();
+		void watchDecks();
+		Task reloadDecks();
+
+		Task acceptConnections();
+		Task handshake(std::unique_ptr<Client> client);
+		Task joinLobby(std::unique_ptr<Client>& client, bool& accepted);
+		Task resumeSession(std::unique_ptr<Client>& client, bool& accepted);
+		Task watchTable(std::unique_ptr<Client>& client, bool& accepted);
+		Task receiveUsernameFromClient(Client& client);
+		void handOver(int shard, ShardCommandType type, std::unique_ptr<Client> client);
+		int placeJoiner() const;
+		void stopIfIdle();
+		void stopAccepting();
+
+		void startShards();
+		Task receiveReports();
+		void releasePlayers(const ShardReport& report);
+		void closeLobbiesIfNobodyGotATable();
+		void addTable(const ShardReport& report);
+		void saveTableState(ShardReport& report);
+		void endGame(const ShardReport& report);
+		void closeLobby(const ShardReport& report);
+
+		void saveCheckpoint();
+		void restoreCheckpoint();
+		void writeCheckpoint(int sequence, const std::vector<char>& data);
+		void discardCheckpoint();
 
 		std::shared_ptr<WSAManager> wsaManager;
+		std::shared_ptr<Executor> executor;
+		EventLoop loop;
 		Socket listening;
 
 		std::string settingsFilepath;
-		std::unique_ptr<Game> game;
+		std::string checkpointFilepath;
+		std::string eventLogFilepath;
+		TableSettings tableSettings;
+		std::chrono::milliseconds lobbyTimeout;
+		int minNumOfPlayers;
+		// tables the server deals before it stops taking players, 0 for no limit
+		int maxNumOfTables;
+		int numOfTablesDealt;
+		int nextTableNumber;
+		int numOfShards;
+		bool accepting;
+		std::mt19937_64 sessionTokenGenerator;
+		std::shared_ptr<DeckLibrary> decks;
+		Timer deckWatch;
+		bool reloadingDecks;
 		Interface& userInterface;
 
-		std::vector<std::unique_ptr<Client>> clients;
-		std::thread masterThread;
-		std::vector<std::thread> sendClientThreads;
-		std::vector<std::thread> receiveClientThreads;
-
-		std::map<int, std::pair<int, std::vector<std::string>>> playerStatementCardChoices;
-		int tsarChoiceIndex;
-
-		bool doneGenerating;
-		std::condition_variable doneGeneratingCvar;
-		std::mutex doneGeneratingMutex;
-
-		std::atomic<int> dataSentCounter;
-		std::condition_variable dataSentCvar;
-		std::mutex dataSentMutex;
-
-		std::atomic<int> receivedStatementCardChoicesCounter;
-		std::condition_variable receivedStatementCardChoicesCvar;
-		std::mutex receivedStatementCardChoicesMutex;
-
-		bool shuffledStatementCards;
-		std::condition_variable shuffledStatementCardsCvar;
-		std::mutex shuffledStatementCardsMutex;
-
-		std::atomic<int> sentStatementCardChoicesCounter;
-		std::condition_variable sentStatementCardChoicesCvar;
-		std::mutex sentStatementCardChoicesMutex;
-
-		bool receivedTsarStatementCard;
-		std::condition_variable receivedTsarStatementCardCvar;
-		std::mutex receivedTsarStatementCardMutex;
-
-		std::atomic<int> sentTsarStatementCardChoiceCounter;
-		std::condition_variable sentTsarStatementCardChoiceCvar;
-		std::mutex sentTsarStatementCardChoiceMutex;
-
-		std::atomic<int> sentServerConfirmationCounter;
-		std::condition_variable sentServerConfirmationCvar;
-		std::mutex sentServerConfirmationMutex;
-
-		std::atomic<int> receivedNextRoundConfirmationCounter;
-		std::condition_variable receivedNextRoundConfirmationCvar;
-		std::mutex receivedNextRoundConfirmationMutex;
-
-		bool resetFlags;
-		std::condition_variable resetFlagsCvar;
-		std::mutex resetFlagsMutex;
+		// rung by the shards when they left a report
+		Doorbell doorbell;
+		std::vector<std::unique_ptr<Shard>> shards;
+		std::vector<ShardStatus> shardStatus;
+		// where the newest table is played, spectators are sent to watch it
+		int newestTableShard;
+		bool stopping;
+		// the shard seating each player, for players resuming their session
+		std::unordered_map<SessionToken, int> sessions;
+		// names of everyone waiting in a lobby or holding a seat
+		UsernameRegistry usernames;
+
+		// the latest state of every table that got through a round, by table number
+		std::map<int, std::vector<char>> tableCheckpoints;
+		// every table that got through a round by the next tick goes into the same checkpoint
+		Timer checkpointTimer;
+		// checkpoints are written behind on the executor; the sequence keeps a slow write from
+		// overwriting a newer one
+		std::mutex checkpointMutex;
+		int checkpointSequence;
+		int lastWrittenCheckpoint;
+
+		EventLog eventLog;
+		long long restoredEventLogSize;
 };
\ No newline at end of file
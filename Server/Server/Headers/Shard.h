@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Client.h"
+#include "DeckLibrary.h"
+#include "EventLoop.h"
+#include "Executor.h"
+#include "Lobby.h"
+#include "Mailbox.h"
+#include "Protocol.h"
+#include "Table.h"
+#include "Task.h"
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace shard
+{
+	// messages in flight each way between the server and a shard before the sender keeps them back
+	const int MAILBOX_CAPACITY = 1024;
+}
+
+class Interface;
+
+enum class ShardCommandType : int
+{
+	// the client's name is reserved and its session token drawn, it waits in the shard's lobby
+	Join = 0,
+	// the client's session token is one of the shard's seated players
+	Resume = 1,
+	Spectate = 2,
+	CloseLobby = 3,
+	Stop = 4
+};
+
+class ShardCommand
+{
+	public:
+		ShardCommandType type;
+		// the handshake's connection with what was read from it, set up again on the shard's loop
+		std::unique_ptr<Client> client;
+};
+
+enum class ShardReportType : int
+{
+	// players sent home or gone from the lobby, their names are free again
+	Left = 0,
+	// the same, sent home because the lobby expired before a table could be dealt
+	LobbyExpired = 1,
+	TableDealt = 2,
+	RoundEnded = 3,
+	GameEnded = 4,
+	LobbyClosed = 5
+};
+
+class ShardReport
+{
+	public:
+		ShardReportType type;
+		int shard;
+		int table;
+		std::vector<std::string> usernames;
+		// the players seated when a table is dealt, the ones to forget when its game ends
+		std::vector<SessionToken> sessionTokens;
+		// the table's checkpoint after a round
+		std::vector<char> data;
+		// the table's events since its last report, after a round and once the game is over
+		std::vector<char> records;
+};
+
+/*
+	A thread with its own event loop, lobby and tables. The server hands it connections whose
+	handshake it read and the shard owns them from then on: it answers the handshake, reads their
+	messages and plays their tables without sharing anything with other shards. What the server
+	needs to know, names to free, sessions, checkpoints and event records, comes back as reports.
+	Both directions are single producer, single consumer mailboxes, so no lock is taken between
+	the threads outside of the executor and the console.
+*/
+class Shard
+{
+	public:
+		Shard(int index, int numOfShards, EventLoop& serverLoop, Doorbell& serverDoorbell, Executor& executor, Interface& userInterface,
+			std::shared_ptr<DeckLibrary> decks, const TableSettings& tableSettings, int minNumOfPlayers, std::chrono::milliseconds lobbyTimeout);
+
+		Shard(const Shard&) = delete;
+		Shard& operator=(const Shard&) = delete;
+
+		// before start: a table saved in the checkpoint, played on here once its players resume
+		Table& restoreTable(const std::vector<char>& state);
+		void discardRestoredTables();
+
+		// new tables are numbered from firstTableNumber on, every numOfShards-th number is this shard's;
+		// the lobby stays open until tableQuota tables were dealt, or for good when it is negative
+		void start(int firstTableNumber, int tableQuota);
+		void join();
+
+		// the server's thread
+		inline void send(ShardCommand command) { commands.send(std::move(command)); }
+		inline bool receive(ShardReport& report) { return reports.receive(report); }
+		inline bool hasCommandsHeldBack() const { return commands.hasHeldBack(); }
+	private:
+		void run();
+		Task receiveCommands();
+		bool connect(Client& client);
+
+		Task joinLobby(std::unique_ptr<Client> client);
+		Task resumeSession(std::unique_ptr<Client> client);
+		Task watchTable(std::unique_ptr<Client> client);
+		Task readMessages(std::shared_ptr<Client> client);
+		void dropClient(Client& client, const std::string& reason);
+		void sendHome(const Lobby::Players& players, ShardReportType type = ShardReportType::Left);
+		void closeLobby();
+		void stop();
+
+		void openTable(Lobby::Players players);
+		Table& addTable(int number);
+		void endGame(Table& table);
+		void removeTable(Table& table);
+		void report(ShardReportType type, int table = 0, std::vector<std::string> usernames = {}, std::vector<SessionToken> sessionTokens = {},
+			std::vector<char> data = {}, std::vector<char> records = {});
+
+		int index;
+		int numOfShards;
+		EventLoop loop;
+		Executor& executor;
+		Interface& userInterface;
+		std::shared_ptr<DeckLibrary> decks;
+		TableSettings tableSettings;
+		std::chrono::milliseconds lobbyTimeout;
+		int nextTableNumber;
+		int tableQuota;
+		int numOfTablesDealt;
+		bool running;
+		std::thread thread;
+
+		Doorbell doorbell;
+		Mailbox<ShardCommand> commands;
+		Mailbox<ShardReport> reports;
+
+		Lobby lobby;
+		std::list<std::unique_ptr<Table>> tables;
+		// tables whose game is over, until their last coroutine is done with them
+		std::list<std::unique_ptr<Table>> endedTables;
+		std::unordered_map<SessionToken, Table*> sessions;
+		// spectators that came before the shard dealt a table, they watch its first one
+		std::vector<std::unique_ptr<AsyncSocket>> waitingSpectators;
+};
\ No newline at end of file
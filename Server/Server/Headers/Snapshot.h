@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace snapshot
+{
+	const int MAGIC = 0x53484143; // "CAHS"
+	const int VERSION = 5;
+}
+
+/*
+	Compact binary form of the live tables, written at the end of every round so a restarted
+	server can pick its games back up. Fixed-size fields are stored raw, strings and lists
+	are prefixed by their length.
+*/
+class SnapshotWriter
+{
+	public:
+		void writeInt(int value) { writeRaw(&value, sizeof(int)); }
+		void writeLongLong(unsigned long long value) { writeRaw(&value, sizeof(unsigned long long)); }
+		void writeBool(bool value) { writeRaw(&value, sizeof(bool)); }
+
+		void writeString(std::string_view text)
+		{
+			writeInt(text.length());
+			writeRaw(text.data(), text.length());
+		}
+
+		// a block encoded by another writer, such as one table's part of the checkpoint
+		void writeBytes(const std::vector<char>& bytes)
+		{
+			writeInt(bytes.size());
+			writeRaw(bytes.data(), bytes.size());
+		}
+
+		inline const std::vector<char>& getData() const { return data; }
+		// keeps the buffer, so a writer reused for every record stops allocating
+		inline void clear() { data.clear(); }
+		inline void reserve(std::size_t capacity) { data.reserve(capacity); }
+		// hands what was written over and keeps the other buffer's memory to write the next one into
+		inline void swapData(std::vector<char>& other) { data.swap(other); }
+	private:
+		void writeRaw(const void* bytes, int size)
+		{
+			const char* begin = static_cast<const char*>(bytes);
+			// insert sizes the buffer exactly when a block is larger than what is written so far, a
+			// checkpoint a few bytes longer than the last one would then never fit the old buffer
+			if (data.size() + size > data.capacity())
+			{
+				data.reserve(std::max(2 * data.capacity(), data.size() + size));
+			}
+			data.insert(data.end(), begin, begin + size);
+		}
+
+		std::vector<char> data;
+};
+
+class SnapshotReader
+{
+	public:
+		// reads data[begin, end), so a reader over one record can't run into the next
+		SnapshotReader(const std::vector<char>& data, int begin = 0, int end = -1) :
+			data{ data },
+			offset{ begin },
+			end{ end < 0 ? static_cast<int>(data.size()) : end }
+		{
+
+		}
+
+		int readInt()
+		{
+			int value;
+			readRaw(&value, sizeof(int));
+			return value;
+		}
+
+		unsigned long long readLongLong()
+		{
+			unsigned long long value;
+			readRaw(&value, sizeof(unsigned long long));
+			return value;
+		}
+
+		bool readBool()
+		{
+			bool value;
+			readRaw(&value, sizeof(bool));
+			return value;
+		}
+
+		std::string readString()
+		{
+			int length = readInt();
+			if (length < 0)
+			{
+				throw SnapshotException("Corrupt snapshot.");
+			}
+			require(length);
+			std::string text(data.begin() + offset, data.begin() + offset + length);
+			offset += length;
+			return text;
+		}
+
+		std::vector<char> readBytes()
+		{
+			int length = readCount();
+			std::vector<char> bytes(data.begin() + offset, data.begin() + offset + length);
+			offset += length;
+			return bytes;
+		}
+
+		// list lengths come from the file, so they are checked before anything is allocated for them
+		int readCount()
+		{
+			int count = readInt();
+			if (count < 0 || count > end - offset)
+			{
+				throw SnapshotException("Corrupt snapshot.");
+			}
+			return count;
+		}
+		// older writers stop where a newer one appends fields
+		inline bool isAtEnd() const { return offset >= end; }
+	private:
+		void readRaw(void* bytes, int size)
+		{
+			require(size);
+			std::memcpy(bytes, &data[offset], size);
+			offset += size;
+		}
+
+		void require(int size)
+		{
+			if (size < 0 || size > end - offset)
+			{
+				throw SnapshotException("Truncated snapshot.");
+			}
+		}
+
+		const std::vector<char>& data;
+		int offset;
+		int end;
+};
\ No newline at end of file
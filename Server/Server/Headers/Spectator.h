@@ -0,0 +1,107 @@
+#pragma once
+
+#include "AsyncSocket.h"
+#include "EventLoop.h"
+
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace spectator
+{
+	// frames a slow spectator can fall behind by before the oldest ones are dropped
+	const int MAX_QUEUED_FRAMES = 4;
+	// time spectators get to receive the last frames once the game is over
+	const int DRAIN_TIMEOUT_MILLISECONDS = 5000;
+	// a few frames; a slow spectator falls further behind in its frame queue, where frames are dropped
+	const int SEND_QUEUE_HIGH_WATERMARK = 8 * 1024;
+	const int SEND_QUEUE_LOW_WATERMARK = 2 * 1024;
+}
+
+// one encoded view of the table, shared by every spectator it was queued for
+using SpectatorFrame = std::shared_ptr<const std::vector<char>>;
+
+/*
+	Read-only connection watching the table. A frame is encoded once per update and only its
+	reference is queued here, the spectator's writer sends the frames in order. Every frame
+	shows the whole table, so a spectator that can't keep up loses its oldest queued frames
+	and jumps ahead: its queue never grows past MAX_QUEUED_FRAMES and players never wait on it.
+*/
+class Spectator
+{
+	public:
+		class Awaiter
+		{
+			public:
+				Awaiter(Spectator& spectator) :
+					spectator{ spectator }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return !spectator.frames.empty() || spectator.finished; }
+				void await_suspend(std::coroutine_handle<> coroutine) { spectator.waiter = coroutine; }
+
+				// empty once the spectator is finished and everything queued was taken
+				SpectatorFrame await_resume()
+				{
+					if (spectator.frames.empty())
+					{
+						return nullptr;
+					}
+					SpectatorFrame frame = std::move(spectator.frames.front());
+					spectator.frames.pop_front();
+					return frame;
+				}
+			private:
+				Spectator& spectator;
+		};
+
+		Spectator(std::unique_ptr<AsyncSocket> connection) :
+			connection{ std::move(connection) },
+			finished{ false },
+			frames{ this->connection->getLoop().memory() }
+		{
+			this->connection->setWatermarks(spectator::SEND_QUEUE_LOW_WATERMARK, spectator::SEND_QUEUE_HIGH_WATERMARK);
+		}
+
+		Spectator(const Spectator&) = delete;
+		Spectator& operator=(const Spectator&) = delete;
+
+		void push(SpectatorFrame frame)
+		{
+			if (frames.size() == spectator::MAX_QUEUED_FRAMES)
+			{
+				frames.pop_front();
+			}
+			frames.emplace_back(std::move(frame));
+			wake();
+		}
+
+		// the writer sends what is still queued, then stops
+		void finish()
+		{
+			finished = true;
+			wake();
+		}
+
+		Awaiter next() { return Awaiter(*this); }
+
+		inline AsyncSocket& getConnection() { return *connection; }
+	private:
+		void wake()
+		{
+			if (waiter)
+			{
+				connection->getLoop().schedule(waiter);
+				waiter = nullptr;
+			}
+		}
+
+		std::unique_ptr<AsyncSocket> connection;
+		bool finished;
+		std::pmr::deque<SpectatorFrame> frames;
+		std::coroutine_handle<> waiter;
+};
\ No newline at end of file
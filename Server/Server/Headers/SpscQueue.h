@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace spsc
+{
+	// the producer's and the consumer's indices sit on separate lines so they don't bounce between cores
+	const std::size_t CACHE_LINE_SIZE = 64;
+}
+
+/*
+	Bounded lock-free queue between exactly one producer and one consumer thread. Each side
+	only writes its own index and keeps a copy of the other one, which it refreshes only when
+	the queue looks full (or empty), so most pushes and pops touch no shared cache line at all.
+*/
+template <typename T>
+class SpscQueue
+{
+	public:
+		// rounded up to a power of two
+		SpscQueue(std::size_t capacity) :
+			slots(roundUp(capacity)),
+			mask{ slots.size() - 1 },
+			head{ 0 },
+			cachedTail{ 0 },
+			tail{ 0 },
+			cachedHead{ 0 }
+		{
+
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		// producer only; false when the queue is full
+		bool tryPush(T&& value)
+		{
+			std::size_t position = tail.load(std::memory_order_relaxed);
+			if (position - cachedHead == slots.size())
+			{
+				cachedHead = head.load(std::memory_order_acquire);
+				if (position - cachedHead == slots.size())
+				{
+					return false;
+				}
+			}
+			slots[position & mask] = std::move(value);
+			tail.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer only; false when the queue is empty
+		bool tryPop(T& value)
+		{
+			std::size_t position = head.load(std::memory_order_relaxed);
+			if (position == cachedTail)
+			{
+				cachedTail = tail.load(std::memory_order_acquire);
+				if (position == cachedTail)
+				{
+					return false;
+				}
+			}
+			value = std::move(slots[position & mask]);
+			head.store(position + 1, std::memory_order_release);
+			return true;
+		}
+	private:
+		static std::size_t roundUp(std::size_t capacity)
+		{
+			std::size_t size = 1;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+			return size;
+		}
+
+		std::vector<T> slots;
+		std::size_t mask;
+
+		// consumer's side
+		alignas(spsc::CACHE_LINE_SIZE) std::atomic<std::size_t> head;
+		std::size_t cachedTail;
+
+		// producer's side
+		alignas(spsc::CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+		std::size_t cachedHead;
+};
\ No newline at end of file
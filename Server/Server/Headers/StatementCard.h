@@ -1,22 +1,24 @@
 #pragma once
 
+#include "TextArena.h"
+
 #include <string>
+#include <string_view>
 #include <iostream>
 
 class StatementCard
 {
 	public:
 	   StatementCard() = default;
-	    StatementCard(const std::string& text) :
+	    StatementCard(std::string_view text) :
 		    text{ text }
 	    {
 
     	}
 
-		inline friend std::istream& operator>>(std::istream& inputStream, StatementCard& card)
+		inline friend TextArena& operator>>(TextArena& arena, StatementCard& card)
 		{
-			std::getline(inputStream, card.text);
-			return inputStream;
+			return arena.readLine(card.text);
 		}
 
 		inline friend std::ostream& operator<<(std::ostream& outputStream, const StatementCard& card)
@@ -25,5 +27,5 @@ class StatementCard
 			return outputStream;
 		}
 
-		std::string text;
+		std::string_view text; // points into the deck's arena
 };
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "FastRandom.h"
+#include "Prompt.h"
+
+#include <utility>
+#include <vector>
+
+class Submission
+{
+	public:
+		bool submitted = false;
+		int numOfCards = 0;
+		// positions in the player's hand and the repository IDs of the cards found there
+		int handIndices[prompt::MAX_BLANKS];
+		int cardIds[prompt::MAX_BLANKS];
+};
+
+/*
+	The cards every player put down this round, one fixed-size row per player slot, sized once
+	per game. Rows are filled while the choices phase is open and only read after it closed:
+	shuffle() fixes the order the choices are presented in, once per round, and whoever
+	waits on the phase that follows it sees a table that no longer changes.
+	The order is kept as the inverse of the shuffle, position to player slot, so a verdict
+	given by position finds its author with one lookup.
+*/
+class SubmissionTable
+{
+	public:
+		void resize(int numOfPlayers)
+		{
+			rows.assign(numOfPlayers, Submission());
+			order.reserve(numOfPlayers);
+		}
+
+		void clear()
+		{
+			for (Submission& row : rows)
+			{
+				row.submitted = false;
+				row.numOfCards = 0;
+			}
+			order.clear();
+		}
+
+		// the row is the player's until the phase closes; mark it submitted once it is complete
+		inline Submission& row(int playerIndex) { return rows[playerIndex]; }
+
+		void shuffle(FastRandom& random)
+		{
+			// inside-out Fisher-Yates: each submitter lands on a uniform position among those so far
+			order.clear();
+			for (int playerIndex = 0; playerIndex < rows.size(); playerIndex++)
+			{
+				if (rows[playerIndex].submitted)
+				{
+					int position = random.nextBelow(order.size() + 1);
+					order.emplace_back(playerIndex);
+					std::swap(order.back(), order[position]);
+				}
+			}
+		}
+
+		// tsar and skipped players don't submit, so this can be less than the number of players
+		inline int size() const { return order.size(); }
+		inline bool empty() const { return order.empty(); }
+		inline int getPlayerAt(int position) const { return order[position]; }
+		inline const Submission& getSubmissionAt(int position) const { return rows[order[position]]; }
+	private:
+		std::vector<Submission> rows;
+		// player slots in the order their submissions are presented
+		std::vector<int> order;
+};
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Client.h"
+#include "Deck.h"
+#include "EventLog.h"
+#include "EventLoop.h"
+#include "Executor.h"
+#include "FastRandom.h"
+#include "Game.h"
+#include "PhaseEvent.h"
+#include "Protocol.h"
+#include "RoundArena.h"
+#include "Snapshot.h"
+#include "Spectator.h"
+#include "SubmissionTable.h"
+#include "Task.h"
+#include "TimeoutPolicy.h"
+#include "TimerWheel.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Interface;
+
+class TableSettings
+{
+	public:
+		GameConfiguration configuration;
+		std::chrono::milliseconds phaseTimeout;
+		TimeoutPolicy timeoutPolicy;
+		// tables played out by a benchmark keep the console to its results
+		bool quiet;
+};
+
+/*
+	One game, from dealing its players in to sending them home. The server forms tables out of
+	its lobby or restores them from a checkpoint and keeps them apart otherwise: every table has
+	its own deck version, phases, spectators and round scratch, and records its events until the
+	round ends, when they are handed to the event log with the round's checkpoint.
+*/
+class Table
+{
+	public:
+		using Players = std::vector<std::shared_ptr<Client>>;
+
+		Table(EventLoop& loop, Executor& executor, Interface& userInterface, int number, const TableSettings& settings, std::shared_ptr<const Deck> deck);
+
+		Table(const Table&) = delete;
+		Table& operator=(const Table&) = delete;
+
+		// a new table, dealt for whoever is seated
+		void seat(Players players, unsigned int seed);
+		// a table saved at the end of a round, its players have to resume before it goes on
+		void restoreState(const std::vector<char>& state);
+		void start();
+		// starts a restored table once everyone is back, or after timeout with whoever is
+		void awaitPlayers(std::chrono::milliseconds timeout);
+
+		// the player holding this session token, which has to be one of the table's, takes its seat back on the new connection
+		std::shared_ptr<Client> resume(SessionToken sessionToken, std::unique_ptr<AsyncSocket> connection);
+		void addSpectator(std::unique_ptr<AsyncSocket> connection);
+
+		inline int getNumber() const { return number; }
+		inline const Players& getPlayers() const { return clients; }
+		inline bool isStarted() const { return started; }
+		// the table as it was at the end of the last round, empty before the first one ended
+		inline const std::vector<char>& getCheckpoint() const { return checkpoint; }
+		// the events since the last round ended, the checkpoint after them is taken with them
+		inline const std::vector<char>& getEventRecords() const { return records; }
+
+		std::function<void(Table&)> onRoundEnded;
+		// the game is over and its events are recorded, the players are on their way out
+		std::function<void(Table&)> onGameEnded;
+		// nothing of the table runs anymore, it can be destroyed
+		std::function<void(Table&)> onIdle;
+	private:
+		void createGame();
+		bool allPlayersPresent() const;
+		Task tracked(Task task);
+		void printMessage(const std::string& message);
+		void printMessage(std::initializer_list<std::string_view> parts);
+
+		Task spectatorSession(Spectator& spectator);
+		void publishToSpectators(TableStage stage);
+		void finishSpectators();
+
+		Task sendPlayerIDToClient(int clientIndex);
+		Task sendPlayerListToClient(int clientIndex);
+		Task sendNumOfRoundsToClient(int clientIndex);
+		Task sendNumOfStatementCardsToClient(int clientIndex);
+		Task sendGeneratedTsarIndexToClient(int clientIndex);
+		Task sendGeneratedPromptToClient(int clientIndex);
+		Task sendGeneratedStatementCardsToClient(int clientIndex);
+		Task sendStatementCardChoicesToClient(int clientIndex);
+		Task sendTsarStatementCardChoiceToClient(int clientIndex);
+		Task sendServerConfirmationToClient(int clientIndex);
+		Task sendSnapshotToClient(int clientIndex, int round);
+
+		void receiveStatementCardChoiceFromClient(int clientIndex, const Message& message);
+		void receiveStatementCardChoiceFromTsar(const Message& message);
+		void autoPlayStatementCardChoice(int clientIndex);
+		void autoPlayTsarChoice();
+		void setRoundWinner(int choiceIndex);
+
+		Task gameLogic();
+		Task playerSession(int clientIndex);
+		Task receiveMessage(int clientIndex, MessageType type, int round, std::optional<Message>& message);
+		Task guarded(int clientIndex, Task operation);
+		bool handleMissedDeadline(int clientIndex);
+		void dropClient(Client& client, const std::string& reason);
+		void printSendQueueMetrics();
+		void resetData();
+		void saveState(int nextRound);
+
+		// what an event of this many ints takes in the records
+		static std::size_t getMaxRecordBytes(int numOfInts);
+		std::size_t getMaxRecordBytesPerRound() const;
+		std::size_t getMaxCheckpointBytesPerRound() const;
+		void logGameStarted();
+		void logRoundDealt();
+		SnapshotWriter& newEvent();
+		void logCardsSubmitted(int clientIndex, const Submission& submission, bool autoPlayed);
+		void logWinnerChosen();
+		void logGameEnded();
+
+		Task generateData_();
+		void shuffleStatementCards_();
+
+		Task sendData_(int clientIndex, int round);
+		Task sendStatementCardChoices_(int clientIndex);
+		Task sendTsarChoice_(int clientIndex);
+		Task sendConfirmation_(int clientIndex);
+
+		Task receiveData_(int clientIndex, int round);
+		Task receiveTsarChoice_(int clientIndex, int round);
+		Task receiveConfirmation_(int clientIndex, int round);
+
+		EventLoop& loop;
+		Executor& executor;
+		Interface& userInterface;
+		int number;
+		// put in front of every message, the console shows all tables at once
+		std::string label;
+		GameConfiguration configuration;
+		std::chrono::milliseconds phaseTimeout;
+		TimeoutPolicy timeoutPolicy;
+		bool quiet;
+		// the table keeps this version of the decks even if they are reloaded while it plays
+		std::shared_ptr<const Deck> deck;
+		unsigned int seed;
+		std::unique_ptr<Game> game;
+		Players clients;
+		bool started;
+		bool finished;
+		int firstRound;
+		int currentRound;
+		Timer resumeDeadline;
+		// coroutines of the table still running; it is idle once the game ended and they are done
+		int activeTasks;
+
+		std::vector<std::unique_ptr<Spectator>> spectators;
+		// the newest frame, reused for the next one once no spectator holds it anymore
+		std::shared_ptr<std::vector<char>> latestFrame;
+		SnapshotWriter frameWriter;
+		Timer spectatorDeadline;
+
+		// scratch of the round's handlers, dropped together when the round ends
+		RoundArena roundArena;
+		SubmissionTable submissions;
+		// reseeded every round: shuffles the submissions and plays for whoever misses a deadline
+		FastRandom roundRandom;
+		int tsarChoiceIndex;
+		int roundWinnerIndex;
+
+		PhaseEvent roundDataGenerated;
+		PhaseEvent receivedStatementCardChoices;
+		PhaseEvent shuffledStatementCards;
+		PhaseEvent receivedTsarStatementCard;
+		PhaseEvent receivedNextRoundConfirmation;
+		PhaseBarrier roundEnd;
+
+		SnapshotWriter checkpointWriter;
+		std::vector<char> checkpoint;
+		// the round's events in the event log's record format, emptied once they were handed over
+		std::vector<char> records;
+		SnapshotWriter eventWriter;
+};
\ No newline at end of file
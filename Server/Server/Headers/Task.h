@@ -0,0 +1,188 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+
+class EventLoop;
+
+namespace task
+{
+	// frames are recycled in size classes this far apart, larger frames go straight to the heap
+	const std::size_t FRAME_SIZE_CLASS = 64;
+	const std::size_t MAX_POOLED_FRAME_SIZE = 4096;
+}
+
+/*
+	Per-thread free lists of coroutine frames. Every round calls the same coroutines again, so
+	once the first round has run, frames come out of a list instead of the heap. A frame freed
+	on another thread than the one that allocated it simply joins that thread's lists.
+*/
+class FramePool
+{
+	public:
+		static void* allocate(std::size_t size)
+		{
+			if (size > task::MAX_POOLED_FRAME_SIZE)
+			{
+				return ::operator new(size);
+			}
+			FreeFrame*& head = freeLists().heads[sizeClass(size)];
+			if (!head)
+			{
+				return ::operator new(sizeClass(size) * task::FRAME_SIZE_CLASS);
+			}
+			FreeFrame* frame = head;
+			head = frame->next;
+			return frame;
+		}
+
+		static void deallocate(void* frame, std::size_t size)
+		{
+			if (size > task::MAX_POOLED_FRAME_SIZE)
+			{
+				::operator delete(frame);
+				return;
+			}
+			FreeFrame*& head = freeLists().heads[sizeClass(size)];
+			head = new (frame) FreeFrame{ head };
+		}
+	private:
+		class FreeFrame
+		{
+			public:
+				FreeFrame* next;
+		};
+
+		class FreeLists
+		{
+			public:
+				~FreeLists()
+				{
+					for (FreeFrame*& head : heads)
+					{
+						while (head)
+						{
+							::operator delete(std::exchange(head, head->next));
+						}
+					}
+				}
+
+				FreeFrame* heads[task::MAX_POOLED_FRAME_SIZE / task::FRAME_SIZE_CLASS + 1] = {};
+		};
+
+		static std::size_t sizeClass(std::size_t size) { return (size + task::FRAME_SIZE_CLASS - 1) / task::FRAME_SIZE_CLASS; }
+
+		static FreeLists& freeLists()
+		{
+			thread_local FreeLists lists;
+			return lists;
+		}
+};
+
+/*
+	Lazily started coroutine. Awaiting a Task runs it to completion and resumes the awaiting
+	coroutine afterwards (symmetric transfer, so long chains don't grow the stack). A Task
+	handed to EventLoop::spawn is detached instead and frees itself once it finishes.
+*/
+class Task
+{
+	public:
+		class promise_type;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		class FinalAwaiter
+		{
+			public:
+				bool await_ready() const noexcept { return false; }
+				std::coroutine_handle<> await_suspend(Handle handle) noexcept;
+				void await_resume() const noexcept { }
+		};
+
+		class promise_type
+		{
+			public:
+				Task get_return_object() { return Task(Handle::from_promise(*this)); }
+				std::suspend_always initial_suspend() const noexcept { return {}; }
+				FinalAwaiter final_suspend() const noexcept { return {}; }
+				void return_void() { }
+				void unhandled_exception() { exception = std::current_exception(); }
+
+				static void* operator new(std::size_t size) { return FramePool::allocate(size); }
+				static void operator delete(void* frame, std::size_t size) { FramePool::deallocate(frame, size); }
+
+				std::coroutine_handle<> continuation;
+				std::exception_ptr exception;
+				EventLoop* owner = nullptr;
+		};
+
+		class Awaiter
+		{
+			public:
+				Awaiter(Handle handle) :
+					handle{ handle }
+				{
+
+				}
+
+				bool await_ready() const noexcept { return !handle || handle.done(); }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept
+				{
+					handle.promise().continuation = awaitingCoroutine;
+					return handle;
+				}
+
+				void await_resume() const
+				{
+					if (handle.promise().exception)
+					{
+						std::rethrow_exception(handle.promise().exception);
+					}
+				}
+			private:
+				Handle handle;
+		};
+
+		Task() = default;
+		Task(Task&& other) noexcept :
+			handle{ std::exchange(other.handle, nullptr) }
+		{
+
+		}
+		Task& operator=(Task&& other) noexcept
+		{
+			if (this != &other)
+			{
+				destroy();
+				handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		}
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		~Task() { destroy(); }
+
+		Awaiter operator co_await() const noexcept { return Awaiter(handle); }
+
+		inline Handle release() { return std::exchange(handle, nullptr); }
+	private:
+		explicit Task(Handle handle) :
+			handle{ handle }
+		{
+
+		}
+
+		void destroy()
+		{
+			if (handle)
+			{
+				handle.destroy();
+				handle = nullptr;
+			}
+		}
+
+		Handle handle;
+};
\ No newline at end of file
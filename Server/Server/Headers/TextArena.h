@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+	All the text of one deck file in a single allocation. Cards hold string_views into it that
+	stay valid for as long as the arena, so handing card text around copies a pointer and a
+	length. Identical lines are interned to one view.
+*/
+class TextArena
+{
+	public:
+		TextArena() :
+			position{ 0 },
+			failed{ false }
+		{
+
+		}
+
+		// the arena owns the text its views point into, so it stays where it was loaded
+		TextArena(const TextArena&) = delete;
+		TextArena& operator=(const TextArena&) = delete;
+
+		void load(const std::string& filepath)
+		{
+			std::ifstream inputFile(filepath, std::ios::binary | std::ios::ate);
+			std::streamoff size = inputFile ? static_cast<std::streamoff>(inputFile.tellg()) : 0;
+			text.resize(size);
+			inputFile.seekg(0);
+			inputFile.read(text.data(), size);
+			position = 0;
+			failed = false;
+			// open addressing at most half full, so the table is a single allocation too
+			size_t numOfLines = std::count(text.begin(), text.end(), '\n') + 1;
+			size_t numOfSlots = 16;
+			while (numOfSlots < 2 * numOfLines)
+			{
+				numOfSlots *= 2;
+			}
+			interned.assign(numOfSlots, std::string_view());
+			occupied.assign(numOfSlots, false);
+		}
+
+		// the next line without its line ending, like std::getline
+		TextArena& readLine(std::string_view& line)
+		{
+			if (position >= text.size())
+			{
+				// interning only matters while the file is read, the views outlive the table
+				failed = true;
+				interned = std::vector<std::string_view>();
+				occupied = std::vector<bool>();
+				return *this;
+			}
+			const char* lineEnd = static_cast<const char*>(std::memchr(text.data() + position, '\n', text.size() - position));
+			size_t end = lineEnd ? lineEnd - text.data() : text.size();
+			size_t length = end - position;
+			if (length > 0 && text[end - 1] == '\r')
+			{
+				length--;
+			}
+			line = intern(std::string_view(text.data() + position, length));
+			position = end + 1;
+			return *this;
+		}
+
+		explicit operator bool() const { return !failed; }
+	private:
+		std::string_view intern(std::string_view line)
+		{
+			size_t slot = std::hash<std::string_view>()(line) & (interned.size() - 1);
+			while (occupied[slot] && interned[slot] != line)
+			{
+				slot = (slot + 1) & (interned.size() - 1);
+			}
+			if (!occupied[slot])
+			{
+				interned[slot] = line;
+				occupied[slot] = true;
+			}
+			return interned[slot];
+		}
+
+		std::vector<char> text;
+		size_t position;
+		bool failed;
+		std::vector<std::string_view> interned;
+		std::vector<bool> occupied;
+};
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+/*
+	What happens to a player who misses a phase deadline. Disconnected players are handled
+	the same way, except that there is no connection left to drop.
+*/
+enum class TimeoutPolicy
+{
+	AutoPlay,       // play random cards / pick a random winner on their behalf
+	SkipPlayer,     // leave them out of this phase
+	DropConnection  // disconnect them; the game continues without them
+};
+
+inline TimeoutPolicy parseTimeoutPolicy(const std::string& policy)
+{
+	if (policy == "skip")
+	{
+		return TimeoutPolicy::SkipPlayer;
+	}
+	if (policy == "drop")
+	{
+		return TimeoutPolicy::DropConnection;
+	}
+	return TimeoutPolicy::AutoPlay;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+/*
+	Usernames in use on the server. A name is reserved when its player takes a seat and stays
+	reserved while the seat is kept, dropped players included, since they may still resume;
+	it is released once the seat is given up. Lookups hash the name where it lies, only a
+	successful reservation copies it. Every handshake runs on the loop's thread, so checking
+	and reserving need no lock.
+*/
+class UsernameRegistry
+{
+	public:
+		// false when the name is already taken
+		bool reserve(std::string_view username)
+		{
+			if (usernames.find(username) != usernames.end())
+			{
+				return false;
+			}
+			usernames.emplace(username);
+			return true;
+		}
+
+		void release(std::string_view username)
+		{
+			auto entry = usernames.find(username);
+			if (entry != usernames.end())
+			{
+				usernames.erase(entry);
+			}
+		}
+
+		inline bool contains(std::string_view username) const { return usernames.find(username) != usernames.end(); }
+		inline int size() const { return usernames.size(); }
+		inline void clear() { usernames.clear(); }
+	private:
+		// lets std::string keys be looked up by string_view without building a string first
+		class Hash
+		{
+			public:
+				using is_transparent = void;
+
+				std::size_t operator()(std::string_view username) const { return std::hash<std::string_view>()(username); }
+		};
+
+		std::unordered_set<std::string, Hash, std::equal_to<>> usernames;
+};
\ No newline at end of file
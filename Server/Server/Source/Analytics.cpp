@@ -0,0 +1,395 @@
+#include "Analytics.h"
+#include "EventLog.h"
+#include "Exceptions.h"
+#include "Deck.h"
+#include "Interface.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+Analytics::Analytics(Interface& userInterface) :
+	userInterface{ userInterface },
+	numOfPlays{ 0 }
+{
+
+}
+
+void Analytics::run(const std::string& eventLogFilepath, const std::string& reportFilepath)
+{
+	auto start = std::chrono::steady_clock::now();
+	indexGames(eventLogFilepath);
+	int numOfGames = gameOffsets.size() - 1; // the last offset only marks the end
+	int numOfChunks = std::min(numOfGames, executor.getNumOfWorkers() * analytics::CHUNKS_PER_WORKER);
+	std::vector<Statistics> chunkStatistics(numOfChunks);
+	std::vector<long long> chunkPlays(numOfChunks);
+	executor.forEach(numOfChunks, [&](int chunk)
+	{
+		PlayColumns plays;
+		RoundColumns rounds;
+		decodeChunk(eventLogFilepath, static_cast<long long>(numOfGames) * chunk / numOfChunks, static_cast<long long>(numOfGames) * (chunk + 1) / numOfChunks, plays, rounds);
+		countChunk(plays, rounds, chunkStatistics[chunk]);
+		chunkPlays[chunk] = plays.card.size();
+	});
+	Statistics statistics(decks.size());
+	for (int chunk = 0; chunk < numOfChunks; chunk++)
+	{
+		merge(statistics, chunkStatistics[chunk]);
+		numOfPlays += chunkPlays[chunk];
+	}
+	auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	userInterface.printMessage("Analyzed " + std::to_string(numOfGames) + " games, " + std::to_string(numOfPlays) + " played cards in " +
+		std::to_string(static_cast<int>(elapsed * 1000)) + " ms on " + std::to_string(executor.getNumOfWorkers()) + " threads");
+	report(statistics, reportFilepath);
+}
+
+void Analytics::indexGames(const std::string& eventLogFilepath)
+{
+	EventLogReader records(eventLogFilepath);
+	std::map<int, int> activeGames;
+	try
+	{
+		while (records.next())
+		{
+			auto activeGame = activeGames.find(records.getTable());
+			if (activeGame != activeGames.end())
+			{
+				gameEnds[activeGame->second] = records.getRecordOffset();
+			}
+			if (records.getType() == EventType::GameStarted)
+			{
+				SnapshotReader event = records.getEvent();
+				GameStartedEvent started(event);
+				auto deck = std::find_if(decks.begin(), decks.end(), [&started](const LoggedDeck& deck)
+				{
+					return deck.promptRepoFilepaths == started.promptRepoFilepaths && deck.statementCardRepoFilepaths == started.statementCardRepoFilepaths &&
+						deck.hasVersion == started.hasDeckVersion && deck.fingerprint == started.deckFingerprint;
+				});
+				if (deck == decks.end())
+				{
+					LoggedDeck loggedDeck{ started.promptRepoFilepaths, started.statementCardRepoFilepaths, started.hasDeckVersion, started.deckFingerprint,
+						started.numOfPromptsInDeck, started.numOfStatementCardsInDeck, std::make_shared<const Deck>(0, started.promptRepoFilepaths, started.statementCardRepoFilepaths) };
+					// an older log doesn't say how big its decks were, the files as they are now have to do
+					if (!loggedDeck.hasVersion)
+					{
+						loggedDeck.numOfPrompts = loggedDeck.current->getPrompts()->size();
+						loggedDeck.numOfStatementCards = loggedDeck.current->getStatementCards()->size();
+					}
+					deck = decks.emplace(decks.end(), std::move(loggedDeck));
+				}
+				activeGames[records.getTable()] = gameOffsets.size();
+				gameOffsets.emplace_back(records.getRecordOffset());
+				gameEnds.emplace_back(records.getRecordOffset());
+				gameTables.emplace_back(records.getTable());
+				gameDecks.emplace_back(deck - decks.begin());
+			}
+		}
+		if (records.isTruncated())
+		{
+			userInterface.printMessage("Event log ends in a partial event, stopping there.");
+		}
+	}
+	catch (SnapshotException& exception)
+	{
+		userInterface.printMessage("Corrupt event log at byte " + std::to_string(records.getRecordOffset()) + ": " + exception.what());
+	}
+	// the last game ends where the readable part of the log does
+	gameOffsets.emplace_back(records.getOffset());
+}
+
+void Analytics::decodeChunk(const std::string& eventLogFilepath, int firstGame, int lastGame, PlayColumns& plays, RoundColumns& rounds) const
+{
+	// every chunk streams its own range of the file
+	EventLogReader records(eventLogFilepath, gameOffsets[firstGame], gameOffsets[lastGame]);
+	std::map<int, int> activeGames = findActiveGames(firstGame);
+	int nextGame = firstGame;
+	int prompt = 0;
+	int firstPlayOfRound = 0;
+	std::vector<int> roundPlayers; // who played each card of the current round, to find the winning ones
+	try
+	{
+		while (records.next())
+		{
+			if (records.getType() == EventType::GameStarted)
+			{
+				activeGames[records.getTable()] = nextGame++;
+				continue;
+			}
+			auto activeGame = activeGames.find(records.getTable());
+			if (activeGame == activeGames.end())
+			{
+				// the events of a game whose start isn't in the log
+				continue;
+			}
+			int game = activeGame->second;
+			SnapshotReader event = records.getEvent();
+			switch (records.getType())
+			{
+				case EventType::RoundDealt:
+					event.readInt(); // round
+					event.readInt(); // tsar
+					prompt = event.readInt();
+					if (prompt < 0 || prompt >= decks[gameDecks[game]].numOfPrompts)
+					{
+						throw SnapshotException("Prompt out of range.");
+					}
+					rounds.deck.emplace_back(gameDecks[game]);
+					rounds.prompt.emplace_back(prompt);
+					rounds.hasWinner.emplace_back(false);
+					firstPlayOfRound = plays.card.size();
+					roundPlayers.clear();
+					break;
+				case EventType::CardsSubmitted:
+				{
+					event.readInt(); // round
+					int player = event.readInt();
+					bool autoPlayed = event.readBool();
+					int numOfChoices = event.readCount();
+					for (int i = 0; i < numOfChoices; i++)
+					{
+						event.readInt(); // hand slot
+						int card = event.readInt();
+						if (card < 0 || card >= decks[gameDecks[game]].numOfStatementCards)
+						{
+							throw SnapshotException("Card out of range.");
+						}
+						plays.deck.emplace_back(gameDecks[game]);
+						plays.prompt.emplace_back(prompt);
+						plays.card.emplace_back(card);
+						plays.won.emplace_back(false);
+						plays.autoPlayed.emplace_back(autoPlayed);
+						roundPlayers.emplace_back(player);
+					}
+					break;
+				}
+				case EventType::WinnerChosen:
+				{
+					event.readInt(); // round
+					int winner = event.readInt();
+					if (!rounds.hasWinner.empty())
+					{
+						rounds.hasWinner.back() = true;
+					}
+					for (int i = 0; i < roundPlayers.size(); i++)
+					{
+						plays.won[firstPlayOfRound + i] = roundPlayers[i] == winner;
+					}
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	}
+	catch (SnapshotException&)
+	{
+		// whatever was decoded before the corrupt event still counts
+	}
+}
+
+std::map<int, int> Analytics::findActiveGames(int game) const
+{
+	// a later game of the same table takes its place
+	std::map<int, int> activeGames;
+	for (int earlierGame = 0; earlierGame < game; earlierGame++)
+	{
+		if (gameEnds[earlierGame] >= gameOffsets[game])
+		{
+			activeGames[gameTables[earlierGame]] = earlierGame;
+		}
+	}
+	return activeGames;
+}
+
+void Analytics::countChunk(const PlayColumns& plays, const RoundColumns& rounds, Statistics& statistics) const
+{
+	statistics.resize(decks.size());
+	for (int i = 0; i < rounds.prompt.size(); i++)
+	{
+		DeckStatistics& deck = statistics[rounds.deck[i]];
+		addAt(deck.promptRounds, rounds.prompt[i], 1);
+		addAt(deck.promptNoWinner, rounds.prompt[i], !rounds.hasWinner[i]);
+	}
+	std::vector<std::vector<unsigned long long>> pairKeys(decks.size());
+	for (int i = 0; i < plays.card.size(); i++)
+	{
+		DeckStatistics& deck = statistics[plays.deck[i]];
+		addAt(deck.cardPlays, plays.card[i], 1);
+		addAt(deck.cardWins, plays.card[i], plays.won[i]);
+		addAt(deck.promptSubmissions, plays.prompt[i], 1);
+		addAt(deck.promptAutoPlayed, plays.prompt[i], plays.autoPlayed[i]);
+		// the lowest bit carries the outcome, so sorting groups the wins of a pair at its end
+		pairKeys[plays.deck[i]].emplace_back((static_cast<unsigned long long>(plays.prompt[i]) << 33) | (static_cast<unsigned long long>(plays.card[i]) << 1) | plays.won[i]);
+	}
+	for (int deckIndex = 0; deckIndex < pairKeys.size(); deckIndex++)
+	{
+		std::vector<unsigned long long>& keys = pairKeys[deckIndex];
+		std::sort(keys.begin(), keys.end());
+		std::vector<PairStatistics>& pairs = statistics[deckIndex].pairs;
+		for (unsigned long long key : keys)
+		{
+			if (pairs.empty() || pairs.back().key != key >> 1)
+			{
+				pairs.emplace_back(PairStatistics{ key >> 1, 0, 0 });
+			}
+			pairs.back().plays++;
+			pairs.back().wins += key & 1;
+		}
+	}
+}
+
+void Analytics::merge(Statistics& statistics, Statistics& chunkStatistics) const
+{
+	for (int deckIndex = 0; deckIndex < chunkStatistics.size(); deckIndex++)
+	{
+		DeckStatistics& deck = statistics[deckIndex];
+		DeckStatistics& chunkDeck = chunkStatistics[deckIndex];
+		addAll(deck.cardPlays, chunkDeck.cardPlays);
+		addAll(deck.cardWins, chunkDeck.cardWins);
+		addAll(deck.promptRounds, chunkDeck.promptRounds);
+		addAll(deck.promptNoWinner, chunkDeck.promptNoWinner);
+		addAll(deck.promptSubmissions, chunkDeck.promptSubmissions);
+		addAll(deck.promptAutoPlayed, chunkDeck.promptAutoPlayed);
+
+		std::vector<PairStatistics> pairs;
+		pairs.reserve(deck.pairs.size() + chunkDeck.pairs.size());
+		std::merge(deck.pairs.begin(), deck.pairs.end(), chunkDeck.pairs.begin(), chunkDeck.pairs.end(), std::back_inserter(pairs),
+			[](const PairStatistics& pair1, const PairStatistics& pair2){ return pair1.key < pair2.key; });
+		deck.pairs.clear();
+		for (auto& pair : pairs)
+		{
+			if (deck.pairs.empty() || deck.pairs.back().key != pair.key)
+			{
+				deck.pairs.emplace_back(pair);
+			}
+			else
+			{
+				deck.pairs.back().plays += pair.plays;
+				deck.pairs.back().wins += pair.wins;
+			}
+		}
+	}
+}
+
+void Analytics::report(const Statistics& statistics, const std::string& reportFilepath) const
+{
+	std::ofstream reportFile(reportFilepath);
+	if (!reportFile)
+	{
+		throw EventLogException("Could not write report " + reportFilepath);
+	}
+	for (int deckIndex = 0; deckIndex < statistics.size(); deckIndex++)
+	{
+		const DeckStatistics& deck = statistics[deckIndex];
+		const LoggedDeck& loggedDeck = decks[deckIndex];
+		Repository<Prompt>& prompts = *loggedDeck.current->getPrompts();
+		Repository<StatementCard>& statementCards = *loggedDeck.current->getStatementCards();
+		// ids of an edited deck point at other cards now, they are reported without text
+		bool textsMatch = !loggedDeck.hasVersion || loggedDeck.fingerprint == loggedDeck.current->getFingerprint();
+		if (!textsMatch)
+		{
+			userInterface.printMessage("Decks " + loggedDeck.promptRepoFilepaths + " / " + loggedDeck.statementCardRepoFilepaths +
+				" changed since the games were played, listing their cards by id.");
+		}
+		auto promptText = [&prompts, textsMatch](int id){ return textsMatch && id < prompts.size() ? std::string(prompts.getObject(id).text) : "#" + std::to_string(id); };
+		auto statementCardText = [&statementCards, textsMatch](int id){ return textsMatch && id < statementCards.size() ? std::string(statementCards.getObject(id).text) : "#" + std::to_string(id); };
+
+		reportFile << "# cards," << loggedDeck.statementCardRepoFilepaths << '\n';
+		reportFile << "card,plays,wins,win rate,text\n";
+		for (int card = 0; card < deck.cardPlays.size(); card++)
+		{
+			if (deck.cardPlays[card] > 0)
+			{
+				reportFile << card << ',' << deck.cardPlays[card] << ',' << deck.cardWins[card] << ',' <<
+					static_cast<double>(deck.cardWins[card]) / deck.cardPlays[card] << ",\"" << statementCardText(card) << "\"\n";
+			}
+		}
+		reportFile << "# prompts," << loggedDeck.promptRepoFilepaths << '\n';
+		reportFile << "prompt,rounds,rounds without winner,submissions,autoplayed,text\n";
+		for (int prompt = 0; prompt < deck.promptRounds.size(); prompt++)
+		{
+			if (deck.promptRounds[prompt] > 0)
+			{
+				int submissions = prompt < deck.promptSubmissions.size() ? deck.promptSubmissions[prompt] : 0;
+				int autoPlayed = prompt < deck.promptAutoPlayed.size() ? deck.promptAutoPlayed[prompt] : 0;
+				reportFile << prompt << ',' << deck.promptRounds[prompt] << ',' << deck.promptNoWinner[prompt] << ',' <<
+					submissions << ',' << autoPlayed << ",\"" << promptText(prompt) << "\"\n";
+			}
+		}
+		reportFile << "# pairs\n";
+		reportFile << "prompt,card,plays,wins\n";
+		for (auto& pair : deck.pairs)
+		{
+			reportFile << (pair.key >> 32) << ',' << (pair.key & 0xFFFFFFFF) << ',' << pair.plays << ',' << pair.wins << '\n';
+		}
+
+		// the summary only ranks what was seen often enough for the rate to mean something
+		std::vector<int> rankedCards;
+		for (int card = 0; card < deck.cardPlays.size(); card++)
+		{
+			if (deck.cardPlays[card] >= analytics::MIN_PLAYS_FOR_RANKING)
+			{
+				rankedCards.emplace_back(card);
+			}
+		}
+		std::sort(rankedCards.begin(), rankedCards.end(), [&deck](int card1, int card2)
+		{
+			return static_cast<long long>(deck.cardWins[card1]) * deck.cardPlays[card2] > static_cast<long long>(deck.cardWins[card2]) * deck.cardPlays[card1];
+		});
+		userInterface.printMessage("Top cards of " + loggedDeck.statementCardRepoFilepaths + ":");
+		for (int i = 0; i < rankedCards.size() && i < analytics::NUM_OF_RANKED; i++)
+		{
+			int card = rankedCards[i];
+			userInterface.printMessage("  " + std::to_string(deck.cardWins[card] * 100 / deck.cardPlays[card]) + "% of " +
+				std::to_string(deck.cardPlays[card]) + " - " + statementCardText(card));
+		}
+
+		// a dud prompt is one players give up on: autoplayed answers or nobody picking a winner
+		std::vector<int> rankedPrompts;
+		for (int prompt = 0; prompt < deck.promptRounds.size(); prompt++)
+		{
+			if (deck.promptRounds[prompt] >= analytics::MIN_PLAYS_FOR_RANKING && prompt < deck.promptSubmissions.size() && deck.promptSubmissions[prompt] > 0)
+			{
+				rankedPrompts.emplace_back(prompt);
+			}
+		}
+		auto dudness = [&deck](int prompt)
+		{
+			return static_cast<double>(deck.promptAutoPlayed[prompt]) / deck.promptSubmissions[prompt] +
+				static_cast<double>(deck.promptNoWinner[prompt]) / deck.promptRounds[prompt];
+		};
+		std::sort(rankedPrompts.begin(), rankedPrompts.end(), [&dudness](int prompt1, int prompt2){ return dudness(prompt1) > dudness(prompt2); });
+		userInterface.printMessage("Likely duds in " + loggedDeck.promptRepoFilepaths + ":");
+		for (int i = 0; i < rankedPrompts.size() && i < analytics::NUM_OF_RANKED; i++)
+		{
+			int prompt = rankedPrompts[i];
+			userInterface.printMessage("  " + std::to_string(deck.promptAutoPlayed[prompt]) + " autoplayed, " +
+				std::to_string(deck.promptNoWinner[prompt]) + " without winner in " + std::to_string(deck.promptRounds[prompt]) +
+				" rounds - " + promptText(prompt));
+		}
+	}
+	userInterface.printMessage("Full report written to " + reportFilepath);
+}
+
+void Analytics::addAt(std::vector<int>& counts, int index, int amount)
+{
+	if (index >= counts.size())
+	{
+		counts.resize(index + 1);
+	}
+	counts[index] += amount;
+}
+
+void Analytics::addAll(std::vector<int>& counts, const std::vector<int>& chunkCounts)
+{
+	if (chunkCounts.size() > counts.size())
+	{
+		counts.resize(chunkCounts.size());
+	}
+	for (int i = 0; i < chunkCounts.size(); i++)
+	{
+		counts[i] += chunkCounts[i];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "AsyncSocket.h"
+#include "Exceptions.h"
+#include "Protocol.h"
+
+AsyncSocket::AsyncSocket(EventLoop& loop, SocketHandle handle) :
+	loop{ loop },
+	handle{ handle },
+	sendQueue{ std::make_shared<SendQueue>(loop, handle) }
+{
+	u_long nonBlocking = 1;
+	if (ioctlsocket(handle, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+	{
+		throw ConnectionException("Failed to make socket non-blocking, error " + std::to_string(WSAGetLastError()));
+	}
+}
+
+Task AsyncSocket::send(const void* data, int size)
+{
+	co_await sendQueue->space();
+	sendQueue->push(data, size);
+}
+
+Task AsyncSocket::send(const GatherWriter& message)
+{
+	co_await sendQueue->space();
+	sendQueue->push(message.getBuffers(), message.getNumOfBuffers());
+}
+
+Task AsyncSocket::receive(void* data, int size)
+{
+	char* buffer = static_cast<char*>(data);
+	int received = 0;
+	while (received < size)
+	{
+		if (sendQueue->isClosed())
+		{
+			throw ConnectionException(sendQueue->getCloseReason());
+		}
+		int result = ::recv(handle, buffer + received, size - received, 0);
+		if (result > 0)
+		{
+			received += result;
+		}
+		else if (result == 0)
+		{
+			throw ConnectionException("Connection closed by peer.");
+		}
+		else if (WSAGetLastError() == WSAEWOULDBLOCK)
+		{
+			co_await loop.readable(handle);
+		}
+		else
+		{
+			throw ConnectionException("recv failed with error " + std::to_string(WSAGetLastError()));
+		}
+	}
+}
+
+Task AsyncSocket::sendString(std::string_view text)
+{
+	int textLength = text.length();
+	co_await send(&textLength, sizeof(int));
+	co_await send(text.data(), textLength);
+}
+
+Task AsyncSocket::receiveString(std::string& text)
+{
+	int textLength;
+	co_await receive(&textLength, sizeof(int));
+	if (textLength < 0 || textLength > protocol::MAX_MESSAGE_LENGTH)
+	{
+		throw ConnectionException("Malformed string length.");
+	}
+	text.resize(textLength);
+	co_await receive(&text[0], textLength);
+}
+
+void AsyncSocket::close()
+{
+	sendQueue->close("Connection closed.");
+}
+
+void AsyncSocket::closeAfterSending()
+{
+	sendQueue->closeWhenSent();
+}
\ No newline at end of file
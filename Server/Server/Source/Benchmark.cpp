@@ -0,0 +1,384 @@
+#include "Benchmark.h"
+#include "Deck.h"
+#include "EventLoop.h"
+#include "Exceptions.h"
+#include "Executor.h"
+#include "Game.h"
+#include "GeneratedRepository.h"
+#include "Interface.h"
+#include "Latch.h"
+#include "SeededGenerator.h"
+#include "Snapshot.h"
+#include "Table.h"
+#include "TimerWheel.h"
+#include "UsernameRegistry.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// the mutex and condition variable pattern Latch and Barrier replaced, done correctly
+	class ConditionBarrier
+	{
+		public:
+			ConditionBarrier(int participants) :
+				participants{ participants },
+				arrived{ 0 },
+				generation{ 0 }
+			{
+
+			}
+
+			void arriveAndWait()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				int currentGeneration = generation;
+				if (++arrived == participants)
+				{
+					arrived = 0;
+					generation++;
+					released.notify_all();
+					return;
+				}
+				released.wait(lock, [this, currentGeneration]{ return generation != currentGeneration; });
+			}
+		private:
+			int participants;
+			int arrived;
+			int generation;
+			std::mutex mutex;
+			std::condition_variable released;
+	};
+
+	// deadlines kept in an ordered tree, the usual alternative to a wheel
+	class OrderedTimers
+	{
+		using Entries = std::multimap<TimerWheel::Clock::time_point, std::function<void()>*>;
+
+		public:
+			OrderedTimers(int numOfTimers) :
+				entries(numOfTimers, timers.end())
+			{
+
+			}
+
+			void schedule(int id, std::function<void()>& callback, std::chrono::milliseconds delay)
+			{
+				cancel(id);
+				entries[id] = timers.emplace(TimerWheel::Clock::now() + delay, &callback);
+			}
+
+			void cancel(int id)
+			{
+				if (entries[id] != timers.end())
+				{
+					timers.erase(entries[id]);
+					entries[id] = timers.end();
+				}
+			}
+
+			void advance(TimerWheel::Clock::time_point now)
+			{
+				while (!timers.empty() && timers.begin()->first <= now)
+				{
+					std::function<void()>* callback = timers.begin()->second;
+					timers.erase(timers.begin());
+					(*callback)();
+				}
+			}
+		private:
+			Entries timers;
+			std::vector<Entries::iterator> entries;
+	};
+
+	// the check the registry replaced: every name in use compared in turn
+	bool isUsernameFree(const std::vector<std::string>& usernames, const std::string& username)
+	{
+		for (auto& other : usernames)
+		{
+			if (other == username)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename Phase>
+	std::chrono::steady_clock::duration runPhases(int numOfThreads, int numOfPhases, Phase& phase)
+	{
+		std::vector<std::thread> threads;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < numOfThreads; i++)
+		{
+			threads.emplace_back([&phase, numOfPhases]
+			{
+				for (int j = 0; j < numOfPhases; j++)
+				{
+					phase.arriveAndWait();
+				}
+			});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		return std::chrono::steady_clock::now() - start;
+	}
+}
+
+Benchmark::Benchmark(Interface& userInterface) :
+	userInterface{ userInterface }
+{
+	benchmarks["latches"] = [this]{ latches(); };
+	benchmarks["timers"] = [this]{ timers(); };
+	benchmarks["snapshots"] = [this]{ snapshots(); };
+	benchmarks["rounds"] = [this]{ rounds(); };
+	benchmarks["usernames"] = [this]{ usernames(); };
+}
+
+void Benchmark::run(const std::string& name)
+{
+	auto benchmark = benchmarks.find(name);
+	if (benchmark == benchmarks.end())
+	{
+		std::string names;
+		for (auto& [benchmarkName, function] : benchmarks)
+		{
+			names += " " + benchmarkName;
+		}
+		throw CommandException("Unknown benchmark, pick one of:" + names);
+	}
+	benchmark->second();
+}
+
+void Benchmark::latches()
+{
+	userInterface.printMessage("Threads meeting " + std::to_string(benchmark::BARRIER_PHASES) + " times, on " +
+		std::to_string(std::thread::hardware_concurrency()) + " cores:");
+	for (int numOfThreads = 2; numOfThreads <= benchmark::MAX_BARRIER_THREADS; numOfThreads *= 2)
+	{
+		Barrier barrier(numOfThreads);
+		printResult("Barrier, " + std::to_string(numOfThreads) + " threads", runPhases(numOfThreads, benchmark::BARRIER_PHASES, barrier), benchmark::BARRIER_PHASES);
+		ConditionBarrier conditionBarrier(numOfThreads);
+		printResult("condition variable, " + std::to_string(numOfThreads) + " threads", runPhases(numOfThreads, benchmark::BARRIER_PHASES, conditionBarrier), benchmark::BARRIER_PHASES);
+	}
+}
+
+void Benchmark::timers()
+{
+	using Clock = TimerWheel::Clock;
+	const int count = benchmark::NUM_OF_TIMERS;
+	// lobby, idle and phase deadlines run from seconds up to an hour
+	std::mt19937 random(count);
+	std::uniform_int_distribution<int> delays(1000, 3600000);
+	std::vector<std::chrono::milliseconds> firstDelays(count);
+	std::vector<std::chrono::milliseconds> secondDelays(count);
+	for (int i = 0; i < count; i++)
+	{
+		firstDelays[i] = std::chrono::milliseconds(delays(random));
+		secondDelays[i] = std::chrono::milliseconds(delays(random));
+	}
+	int fired = 0;
+	auto measure = [this](const std::string& what, int operations, auto operation)
+	{
+		auto start = Clock::now();
+		operation();
+		printResult(what, Clock::now() - start, operations);
+	};
+
+	userInterface.printMessage(std::to_string(count) + " timers, scheduled, rescheduled as an idle deadline is, half cancelled, the rest expired:");
+	{
+		TimerWheel wheel;
+		std::vector<Timer> timers(count);
+		for (Timer& timer : timers)
+		{
+			timer.callback = [&fired]{ fired++; };
+		}
+		measure("TimerWheel schedule", count, [&]{ for (int i = 0; i < count; i++) wheel.schedule(timers[i], firstDelays[i]); });
+		measure("TimerWheel reschedule", count, [&]{ for (int i = 0; i < count; i++) wheel.schedule(timers[i], secondDelays[i]); });
+		measure("TimerWheel cancel", count / 2, [&]{ for (int i = 0; i < count; i += 2) timers[i].cancel(); });
+		measure("TimerWheel expire", count / 2, [&]{ wheel.advance(Clock::now() + std::chrono::hours(2)); });
+	}
+	{
+		OrderedTimers ordered(count);
+		std::vector<std::function<void()>> callbacks(count, [&fired]{ fired++; });
+		measure("multimap schedule", count, [&]{ for (int i = 0; i < count; i++) ordered.schedule(i, callbacks[i], firstDelays[i]); });
+		measure("multimap reschedule", count, [&]{ for (int i = 0; i < count; i++) ordered.schedule(i, callbacks[i], secondDelays[i]); });
+		measure("multimap cancel", count / 2, [&]{ for (int i = 0; i < count; i += 2) ordered.cancel(i); });
+		measure("multimap expire", count / 2, [&]{ ordered.advance(Clock::now() + std::chrono::hours(2)); });
+	}
+	if (fired != count)
+	{
+		userInterface.printMessage("  " + std::to_string(fired) + " timers fired, expected " + std::to_string(count));
+	}
+}
+
+void Benchmark::snapshots()
+{
+	using Clock = std::chrono::steady_clock;
+	const int count = benchmark::NUM_OF_TABLES;
+	auto prompts = std::make_shared<GeneratedRepository<Prompt>>(benchmark::DECK_SIZE);
+	auto statementCards = std::make_shared<GeneratedRepository<StatementCard>>(benchmark::DECK_SIZE);
+	// tables of every size the lobby forms, a few rounds in
+	auto makeGame = [&](int table)
+	{
+		GameConfiguration configuration(3 + table % 6, 10, 7);
+		std::unique_ptr<GeneratorStrategy> strategy = std::unique_ptr<SeededGenerator>(new SeededGenerator(table));
+		std::unique_ptr<GameDataManager> manager = std::unique_ptr<GameDataManager>(new GameDataManager(std::move(strategy)));
+		return std::unique_ptr<Game>(new Game(prompts, statementCards, std::move(manager), configuration));
+	};
+	std::vector<std::unique_ptr<Game>> games;
+	for (int table = 0; table < count; table++)
+	{
+		games.emplace_back(makeGame(table));
+		for (int round = 0; round < 3; round++)
+		{
+			games.back()->generateRoundData();
+			games.back()->setPlayerStatementCardAsUsed((round + 1) % 3, round);
+		}
+	}
+	std::vector<std::unique_ptr<Game>> restoredGames;
+	for (int table = 0; table < count; table++)
+	{
+		restoredGames.emplace_back(makeGame(table));
+	}
+
+	userInterface.printMessage(std::to_string(count) + " tables of 3 to 8 players, saved into one checkpoint and restored from it:");
+	SnapshotWriter writer;
+	auto start = Clock::now();
+	writer.writeInt(snapshot::MAGIC);
+	writer.writeInt(snapshot::VERSION);
+	writer.writeInt(count);
+	for (auto& game : games)
+	{
+		game->saveState(writer);
+	}
+	printResult("save", Clock::now() - start, count);
+	start = Clock::now();
+	try
+	{
+		SnapshotReader reader(writer.getData());
+		reader.readInt();
+		reader.readInt();
+		reader.readInt();
+		for (auto& game : restoredGames)
+		{
+			game->restoreState(reader);
+		}
+		printResult("restore", Clock::now() - start, count);
+	}
+	catch (SnapshotException& exception)
+	{
+		userInterface.printMessage("  restore failed: " + std::string(exception.what()));
+	}
+	userInterface.printMessage("  " + std::to_string(writer.getData().size() / 1024) + " KiB in all");
+}
+
+void Benchmark::rounds()
+{
+	using Clock = std::chrono::steady_clock;
+	auto deck = std::make_shared<const Deck>(1, std::make_shared<GeneratedRepository<Prompt>>(benchmark::DECK_SIZE),
+		std::make_shared<GeneratedRepository<StatementCard>>(benchmark::DECK_SIZE));
+	// nobody is connected, so every phase is autoplayed as soon as it starts and only the server's own work is timed
+	TableSettings settings{ GameConfiguration(4, benchmark::ROUNDS_PER_TABLE, 7), std::chrono::seconds(60), TimeoutPolicy::AutoPlay, true };
+	Executor executor;
+	// a shard as the server runs one: a thread with its own loop and tables, sharing nothing but the executor
+	auto playShard = [&](int shard)
+	{
+		EventLoop loop;
+		std::vector<std::unique_ptr<Table>> tables;
+		for (int i = 0; i < benchmark::TABLES_PER_SHARD; i++)
+		{
+			tables.emplace_back(std::make_unique<Table>(loop, executor, userInterface, i + 1, settings, deck));
+			tables.back()->onRoundEnded = [](Table&){ };
+			tables.back()->onGameEnded = [](Table&){ };
+			tables.back()->onIdle = [](Table&){ };
+			Table::Players players;
+			for (int j = 0; j < settings.configuration.numOfPlayers; j++)
+			{
+				players.emplace_back(std::make_shared<Client>());
+				players.back()->setUsername("Player " + std::to_string(j));
+				players.back()->setDisconnected();
+			}
+			tables.back()->seat(std::move(players), shard * benchmark::TABLES_PER_SHARD + i);
+			tables.back()->start();
+		}
+		loop.run();
+	};
+
+	int numOfCores = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	long long roundsPerShard = static_cast<long long>(benchmark::TABLES_PER_SHARD) * benchmark::ROUNDS_PER_TABLE;
+	userInterface.printMessage(std::to_string(benchmark::TABLES_PER_SHARD) + " tables of 4 autoplayed players per shard, " +
+		std::to_string(benchmark::ROUNDS_PER_TABLE) + " rounds each, on " + std::to_string(numOfCores) + " cores:");
+	double oneShard = 0;
+	for (int numOfShards = 1; numOfShards <= std::max(numOfCores, 2); numOfShards *= 2)
+	{
+		std::vector<std::thread> threads;
+		auto start = Clock::now();
+		for (int shard = 0; shard < numOfShards; shard++)
+		{
+			threads.emplace_back(playShard, shard);
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		double roundsPerSecond = roundsPerShard * numOfShards / seconds;
+		if (numOfShards == 1)
+		{
+			oneShard = roundsPerSecond;
+		}
+		userInterface.printMessage("  " + std::to_string(numOfShards) + " shards: " + std::to_string(static_cast<long long>(roundsPerSecond)) + " rounds/s, " +
+			std::to_string(static_cast<int>(100 * roundsPerSecond / (oneShard * numOfShards))) + "% of linear");
+	}
+}
+
+void Benchmark::usernames()
+{
+	using Clock = std::chrono::steady_clock;
+	const int count = benchmark::NUM_OF_USERS;
+	// spread over the name space the way players pick them, not in order
+	std::vector<std::string> names;
+	for (int i = 0; i < count; i++)
+	{
+		names.emplace_back("player_" + std::to_string(i * 7919 % 1000003));
+	}
+	int reserved = 0;
+	int taken = 0;
+	auto measure = [this](const std::string& what, int operations, auto operation)
+	{
+		auto start = Clock::now();
+		operation();
+		printResult(what, Clock::now() - start, operations);
+	};
+
+	userInterface.printMessage(std::to_string(count) + " players joining, joining again under a name in use and leaving:");
+	UsernameRegistry registry;
+	measure("UsernameRegistry reserve", count, [&]{ for (auto& name : names) reserved += registry.reserve(name); });
+	measure("UsernameRegistry reserve taken", count, [&]{ for (auto& name : names) taken += !registry.reserve(name); });
+	measure("UsernameRegistry release", count, [&]{ for (auto& name : names) registry.release(name); });
+	// the scan grows with every player, so only a sample of joins is timed against the full server
+	const int joins = benchmark::SCANNED_JOINS;
+	measure("scan of " + std::to_string(count) + " names", joins, [&]{ for (int i = 0; i < joins; i++) reserved += isUsernameFree(names, "newcomer_" + std::to_string(i)); });
+	if (reserved != count + joins || taken != count || registry.size() != 0)
+	{
+		userInterface.printMessage("  " + std::to_string(reserved) + " names reserved and " + std::to_string(taken) + " refused, expected " +
+			std::to_string(count + joins) + " and " + std::to_string(count) + ", " + std::to_string(registry.size()) + " left over");
+	}
+}
+
+void Benchmark::printResult(const std::string& what, std::chrono::steady_clock::duration elapsed, long long operations)
+{
+	double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+	userInterface.printMessage("  " + what + ": " + std::to_string(static_cast<long long>(nanoseconds / 1000000)) + " ms, " +
+		std::to_string(static_cast<long long>(nanoseconds / operations)) + " ns each");
+}
\ No newline at end of file
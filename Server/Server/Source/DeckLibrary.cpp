@@ -0,0 +1,48 @@
+#include "DeckLibrary.h"
+#include "Exceptions.h"
+
+DeckLibrary::DeckLibrary(const std::string& promptRepoFilepaths, const std::string& statementCardRepoFilepaths) :
+	promptRepoFilepaths{ promptRepoFilepaths },
+	statementCardRepoFilepaths{ statementCardRepoFilepaths },
+	writeTimes{ lastWriteTimes() },
+	deck{ std::make_shared<const Deck>(1, promptRepoFilepaths, statementCardRepoFilepaths) }
+{
+
+}
+
+bool DeckLibrary::checkForChanges()
+{
+	std::vector<std::filesystem::file_time_type> times = lastWriteTimes();
+	if (times == writeTimes)
+	{
+		return false;
+	}
+	writeTimes = std::move(times);
+	return true;
+}
+
+void DeckLibrary::reload()
+{
+	std::shared_ptr<const Deck> next = std::make_shared<const Deck>(current()->getVersion() + 1, promptRepoFilepaths, statementCardRepoFilepaths);
+	// a file caught halfway through being rewritten usually reads as empty, the next change retries
+	if (next->getPrompts()->size() == 0 || next->getStatementCards()->size() == 0)
+	{
+		throw DeckException("Deck files are empty, keeping version " + std::to_string(current()->getVersion()) + ".");
+	}
+	deck.store(std::move(next), std::memory_order_release);
+}
+
+std::vector<std::filesystem::file_time_type> DeckLibrary::lastWriteTimes() const
+{
+	std::vector<std::filesystem::file_time_type> times;
+	for (auto& filepaths : { promptRepoFilepaths, statementCardRepoFilepaths })
+	{
+		for (auto& filepath : Deck::splitFilepaths(filepaths))
+		{
+			std::error_code error;
+			std::filesystem::file_time_type time = std::filesystem::last_write_time(filepath, error);
+			times.emplace_back(error ? std::filesystem::file_time_type::min() : time);
+		}
+	}
+	return times;
+}
\ No newline at end of file
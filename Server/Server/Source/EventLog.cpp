@@ -0,0 +1,237 @@
+#include "EventLog.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <filesystem>
+
+EventLog::EventLog() :
+	stopping{ false },
+	appended{ 0 }
+{
+
+}
+
+EventLog::~EventLog()
+{
+	close();
+}
+
+void EventLog::open(const std::string& filepath, long long truncatedSize)
+{
+	std::error_code error;
+	long long fileSize = std::filesystem::exists(filepath, error) ? std::filesystem::file_size(filepath, error) : 0;
+	if (truncatedSize >= 0 && truncatedSize < fileSize)
+	{
+		std::filesystem::resize_file(filepath, truncatedSize, error);
+		fileSize = truncatedSize;
+	}
+	if (error)
+	{
+		throw EventLogException("Could not prepare event log " + filepath + ": " + error.message());
+	}
+	file.open(filepath, std::ios::binary | std::ios::app);
+	if (!file)
+	{
+		throw EventLogException("Could not open event log " + filepath);
+	}
+	appended = fileSize;
+	stopping = false;
+	writer = std::thread(&EventLog::writeBatches, this);
+}
+
+void EventLog::close()
+{
+	if (!writer.joinable())
+	{
+		return;
+	}
+	flush();
+	{
+		std::lock_guard<std::mutex> guard(batchGuard);
+		stopping = true;
+	}
+	batchReady.notify_one();
+	writer.join();
+	file.close();
+}
+
+void EventLog::append(EventType type, const SnapshotWriter& event)
+{
+	long long size = buffered.size();
+	encode(buffered, type, event);
+	appended += buffered.size() - size;
+	if (buffered.size() >= eventlog::BATCH_SIZE)
+	{
+		flush();
+	}
+}
+
+void EventLog::appendTableRecords(int table, const std::vector<char>& records)
+{
+	if (records.empty())
+	{
+		return;
+	}
+	int header[] = { static_cast<int>(2 * sizeof(int) + records.size()), static_cast<int>(EventType::TableEvents), table };
+	buffered.insert(buffered.end(), reinterpret_cast<const char*>(header), reinterpret_cast<const char*>(header) + sizeof(header));
+	buffered.insert(buffered.end(), records.begin(), records.end());
+	appended += sizeof(header) + records.size();
+	if (buffered.size() >= eventlog::BATCH_SIZE)
+	{
+		flush();
+	}
+}
+
+void EventLog::encode(std::vector<char>& records, EventType type, const SnapshotWriter& event)
+{
+	const std::vector<char>& payload = event.getData();
+	int length = sizeof(int) + payload.size();
+	int eventType = static_cast<int>(type);
+	records.insert(records.end(), reinterpret_cast<const char*>(&length), reinterpret_cast<const char*>(&length) + sizeof(int));
+	records.insert(records.end(), reinterpret_cast<const char*>(&eventType), reinterpret_cast<const char*>(&eventType) + sizeof(int));
+	records.insert(records.end(), payload.begin(), payload.end());
+}
+
+void EventLog::flush()
+{
+	if (buffered.empty())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> guard(batchGuard);
+		pending.insert(pending.end(), buffered.begin(), buffered.end());
+	}
+	buffered.clear();
+	batchReady.notify_one();
+}
+
+void EventLog::writeBatches()
+{
+	std::vector<char> batch;
+	std::unique_lock<std::mutex> lock(batchGuard);
+	while (true)
+	{
+		batchReady.wait(lock, [this]{ return stopping || !pending.empty(); });
+		if (pending.empty())
+		{
+			return;
+		}
+		batch.swap(pending);
+		lock.unlock();
+		file.write(batch.data(), batch.size());
+		file.flush();
+		batch.clear();
+		lock.lock();
+	}
+}
+
+EventLogReader::EventLogReader(const std::string& filepath, long long begin, long long end) :
+	file{ filepath, std::ios::binary },
+	chunkOffset{ begin },
+	position{ 0 },
+	available{ 0 },
+	end{ end },
+	recordOffset{ begin },
+	recordPosition{ 0 },
+	recordEnd{ 0 },
+	tableEventsEnd{ 0 },
+	type{ EventType::GameStarted },
+	table{ 0 },
+	truncated{ false }
+{
+	if (!file)
+	{
+		throw EventLogException("Could not open event log " + filepath);
+	}
+	std::error_code error;
+	long long fileSize = std::filesystem::file_size(filepath, error);
+	if (error)
+	{
+		throw EventLogException("Could not read event log " + filepath + ": " + error.message());
+	}
+	this->end = end < 0 ? fileSize : std::min(end, fileSize);
+	file.seekg(begin);
+}
+
+bool EventLogReader::next()
+{
+	// the table's events were read whole, the records in them are taken straight from the chunk
+	if (position < tableEventsEnd)
+	{
+		int length = 0;
+		if (tableEventsEnd - position >= sizeof(int))
+		{
+			std::memcpy(&length, &chunk[position], sizeof(int));
+		}
+		if (length < static_cast<int>(sizeof(int)) || length > tableEventsEnd - position - static_cast<int>(sizeof(int)))
+		{
+			throw SnapshotException("Event runs past its table's events.");
+		}
+		std::memcpy(&type, &chunk[position + sizeof(int)], sizeof(int));
+		recordPosition = position;
+		recordEnd = position + sizeof(int) + length;
+		position = recordEnd;
+		return true;
+	}
+	// chunk positions move once the next part of the file is read
+	tableEventsEnd = 0;
+	long long offset = getOffset();
+	if (offset >= end)
+	{
+		return false;
+	}
+	int length = 0;
+	if (fill(sizeof(int)))
+	{
+		std::memcpy(&length, &chunk[position], sizeof(int));
+	}
+	if (length < sizeof(int) || length > eventlog::MAX_RECORD_SIZE || length > end - offset - static_cast<long long>(sizeof(int)) ||
+		!fill(sizeof(int) + length))
+	{
+		truncated = true;
+		return false;
+	}
+	std::memcpy(&type, &chunk[position + sizeof(int)], sizeof(int));
+	recordOffset = offset;
+	recordPosition = position;
+	recordEnd = position + sizeof(int) + length;
+	position = recordEnd;
+	if (type != EventType::TableEvents)
+	{
+		table = 0;
+		return true;
+	}
+	if (length < 2 * sizeof(int))
+	{
+		throw SnapshotException("Table events without a table.");
+	}
+	std::memcpy(&table, &chunk[recordPosition + 2 * sizeof(int)], sizeof(int));
+	tableEventsEnd = recordEnd;
+	position = recordPosition + 3 * sizeof(int);
+	return next();
+}
+
+bool EventLogReader::fill(int size)
+{
+	if (available - position >= size)
+	{
+		return true;
+	}
+	// what is left of the chunk moves to its front and the rest is read behind it
+	std::copy(chunk.begin() + position, chunk.begin() + available, chunk.begin());
+	available -= position;
+	chunkOffset += position;
+	position = 0;
+	if (chunk.size() < std::max(size, eventlog::READ_CHUNK_SIZE))
+	{
+		chunk.resize(std::max(size, eventlog::READ_CHUNK_SIZE));
+	}
+	long long toRead = std::min(static_cast<long long>(chunk.size() - available), end - chunkOffset - available);
+	if (toRead > 0)
+	{
+		file.read(chunk.data() + available, toRead);
+		available += file.gcount();
+	}
+	return available >= size;
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "EventLoop.h"
+#include "Exceptions.h"
+
+#include <string>
+
+std::coroutine_handle<> Task::FinalAwaiter::await_suspend(Handle handle) noexcept
+{
+	promise_type& promise = handle.promise();
+	if (promise.continuation)
+	{
+		return promise.continuation;
+	}
+	if (promise.owner)
+	{
+		promise.owner->taskFinished(handle);
+	}
+	return std::noop_coroutine();
+}
+
+EventLoop::EventLoop() :
+	ready{ &nodes },
+	readers{ &nodes },
+	writers{ &nodes },
+	wakeSocket{ INVALID_SOCKET },
+	running{ false },
+	liveTasks{ 0 }
+{
+	createWakeSocket();
+}
+
+EventLoop::~EventLoop()
+{
+	if (wakeSocket != INVALID_SOCKET)
+	{
+		closesocket(wakeSocket);
+	}
+}
+
+void EventLoop::run()
+{
+	running = true;
+	drainPosted();
+	while (running && (liveTasks > 0 || !ready.empty()))
+	{
+		runReady();
+		if (!running || liveTasks == 0)
+		{
+			break;
+		}
+		pollSockets(timerWheel.millisecondsUntilNextExpiry(TimerWheel::Clock::now()));
+		timerWheel.advance(TimerWheel::Clock::now());
+		drainPosted();
+	}
+	running = false;
+	if (failure)
+	{
+		std::rethrow_exception(std::exchange(failure, nullptr));
+	}
+}
+
+void EventLoop::stop()
+{
+	running = false;
+}
+
+void EventLoop::spawn(Task task)
+{
+	Task::Handle handle = task.release();
+	handle.promise().owner = this;
+	liveTasks++;
+	schedule(handle);
+}
+
+void EventLoop::schedule(std::coroutine_handle<> coroutine)
+{
+	ready.emplace_back(coroutine);
+}
+
+void EventLoop::post(std::coroutine_handle<> coroutine)
+{
+	{
+		std::lock_guard<std::mutex> guard(postedMutex);
+		posted.emplace_back(coroutine);
+	}
+	wake();
+}
+
+void EventLoop::taskFinished(Task::Handle task)
+{
+	// detached tasks are expected to handle their own errors; anything escaping stops the loop
+	if (task.promise().exception && !failure)
+	{
+		failure = task.promise().exception;
+		running = false;
+	}
+	task.destroy();
+	liveTasks--;
+}
+
+void EventLoop::watch(SocketHandle handle, bool write, std::coroutine_handle<> coroutine)
+{
+	if (write)
+	{
+		writers[handle] = coroutine;
+	}
+	else
+	{
+		readers[handle] = coroutine;
+	}
+}
+
+void EventLoop::unwatch(SocketHandle handle)
+{
+	auto reader = readers.find(handle);
+	if (reader != readers.end())
+	{
+		schedule(reader->second);
+		readers.erase(reader);
+	}
+	auto writer = writers.find(handle);
+	if (writer != writers.end())
+	{
+		schedule(writer->second);
+		writers.erase(writer);
+	}
+}
+
+void EventLoop::runReady()
+{
+	while (!ready.empty() && running)
+	{
+		std::coroutine_handle<> coroutine = ready.front();
+		ready.pop_front();
+		coroutine.resume();
+	}
+}
+
+void EventLoop::pollSockets(int timeout)
+{
+	pollSet.clear();
+	pollSet.push_back(WSAPOLLFD{ wakeSocket, POLLRDNORM, 0 });
+	// both maps are ordered by handle, so a merge walk gives one entry per socket
+	auto reader = readers.begin();
+	auto writer = writers.begin();
+	while (reader != readers.end() || writer != writers.end())
+	{
+		if (writer == writers.end() || (reader != readers.end() && reader->first < writer->first))
+		{
+			pollSet.push_back(WSAPOLLFD{ reader->first, POLLRDNORM, 0 });
+			reader++;
+		}
+		else if (reader == readers.end() || writer->first < reader->first)
+		{
+			pollSet.push_back(WSAPOLLFD{ writer->first, POLLWRNORM, 0 });
+			writer++;
+		}
+		else
+		{
+			pollSet.push_back(WSAPOLLFD{ reader->first, POLLRDNORM | POLLWRNORM, 0 });
+			reader++;
+			writer++;
+		}
+	}
+
+	if (WSAPoll(pollSet.data(), pollSet.size(), timeout) == SOCKET_ERROR)
+	{
+		throw EventLoopException("WSAPoll failed with error " + std::to_string(WSAGetLastError()));
+	}
+
+	for (int i = 1; i < pollSet.size(); i++)
+	{
+		// errors and hang-ups wake both directions so the pending send/recv reports them
+		short failed = pollSet[i].revents & (POLLERR | POLLHUP | POLLNVAL);
+		if (pollSet[i].revents & (POLLRDNORM | failed))
+		{
+			auto reader = readers.find(pollSet[i].fd);
+			if (reader != readers.end())
+			{
+				schedule(reader->second);
+				readers.erase(reader);
+			}
+		}
+		if (pollSet[i].revents & (POLLWRNORM | failed))
+		{
+			auto writer = writers.find(pollSet[i].fd);
+			if (writer != writers.end())
+			{
+				schedule(writer->second);
+				writers.erase(writer);
+			}
+		}
+	}
+}
+
+void EventLoop::drainPosted()
+{
+	char buffer[64];
+	while (recv(wakeSocket, buffer, sizeof(buffer), 0) > 0);
+
+	std::lock_guard<std::mutex> guard(postedMutex);
+	for (auto& coroutine : posted)
+	{
+		schedule(coroutine);
+	}
+	posted.clear();
+}
+
+void EventLoop::createWakeSocket()
+{
+	// WSAPoll cannot wait on events, so cross-thread wake-ups go through a loopback datagram socket
+	wakeSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (wakeSocket == INVALID_SOCKET)
+	{
+		throw EventLoopException("Failed to create wake socket.");
+	}
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+	int addressLength = sizeof(address);
+	u_long nonBlocking = 1;
+	if (bind(wakeSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR ||
+		getsockname(wakeSocket, reinterpret_cast<sockaddr*>(&address), &addressLength) == SOCKET_ERROR ||
+		connect(wakeSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR ||
+		ioctlsocket(wakeSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+	{
+		throw EventLoopException("Failed to set up wake socket, error " + std::to_string(WSAGetLastError()));
+	}
+}
+
+void EventLoop::wake()
+{
+	char signal = 0;
+	send(wakeSocket, &signal, sizeof(signal), 0);
+}
\ No newline at end of file
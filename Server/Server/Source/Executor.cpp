@@ -0,0 +1,171 @@
+#include "Executor.h"
+#include "EventLoop.h"
+
+#include <algorithm>
+
+namespace
+{
+	// lets submit() push onto the calling worker's own deque instead of a shared one
+	thread_local Executor* currentExecutor = nullptr;
+	thread_local int currentWorkerIndex = -1;
+}
+
+Executor::Executor(int numOfWorkers) :
+	running{ true },
+	pendingTasks{ 0 },
+	nextQueue{ 0 }
+{
+	numOfWorkers = std::max(numOfWorkers, 1);
+	for (int i = 0; i < numOfWorkers; i++)
+	{
+		queues.emplace_back(std::make_unique<WorkerQueue>());
+	}
+	for (int i = 0; i < numOfWorkers; i++)
+	{
+		workers.emplace_back(&Executor::workerLoop, this, i);
+	}
+}
+
+Executor::~Executor()
+{
+	running = false;
+	pendingTasks.fetch_add(1, std::memory_order_release);
+	pendingTasks.notify_all();
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void Executor::submit(ExecutorTask task)
+{
+	int queueIndex = currentExecutor == this ? currentWorkerIndex : nextQueue++ % queues.size();
+	{
+		std::lock_guard<std::mutex> guard(queues[queueIndex]->mutex);
+		queues[queueIndex]->tasks.emplace_back(std::move(task));
+	}
+	pendingTasks.fetch_add(1, std::memory_order_release);
+	pendingTasks.notify_one();
+}
+
+void Executor::forEach(int count, const IndexedTask& task)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	Latch done(count);
+	for (int i = 0; i < count; i++)
+	{
+		submit([&task, &done, i]{ task(i); done.countDown(); });
+	}
+	// the waiting thread runs queued work itself, a worker blocking here could otherwise be the
+	// only one left to run the tasks it just pushed onto its own deque
+	while (!done.ready())
+	{
+		if (runPendingTask())
+		{
+			continue;
+		}
+		if (currentExecutor != this)
+		{
+			done.wait();
+		}
+		else
+		{
+			// what is left runs on other workers, which may in turn need this one's deque drained
+			std::this_thread::yield();
+		}
+	}
+}
+
+void Executor::workerLoop(int workerIndex)
+{
+	currentExecutor = this;
+	currentWorkerIndex = workerIndex;
+	int spins = 0;
+	while (true)
+	{
+		ExecutorTask task;
+		if (popTask(workerIndex, task) || stealTask(workerIndex, task))
+		{
+			pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+			task();
+			spins = 0;
+		}
+		else if (!running)
+		{
+			// stopping drains the queues first, so work submitted before the destructor still runs
+			break;
+		}
+		else if (spins < latch::SPIN_COUNT)
+		{
+			spins++;
+			std::this_thread::yield();
+		}
+		else
+		{
+			pendingTasks.wait(0, std::memory_order_acquire);
+			spins = 0;
+		}
+	}
+}
+
+bool Executor::runPendingTask()
+{
+	ExecutorTask task;
+	int workerIndex = currentExecutor == this ? currentWorkerIndex : 0;
+	if ((currentExecutor == this && popTask(workerIndex, task)) || stealTask(workerIndex, task))
+	{
+		pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+		task();
+		return true;
+	}
+	return false;
+}
+
+bool Executor::popTask(int workerIndex, ExecutorTask& task)
+{
+	WorkerQueue& queue = *queues[workerIndex];
+	std::lock_guard<std::mutex> guard(queue.mutex);
+	if (queue.tasks.empty())
+	{
+		return false;
+	}
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	return true;
+}
+
+bool Executor::stealTask(int workerIndex, ExecutorTask& task)
+{
+	// the own deque comes last, a thread outside the executor steals from every deque
+	for (int offset = 1; offset <= queues.size(); offset++)
+	{
+		WorkerQueue& victim = *queues[(workerIndex + offset) % queues.size()];
+		std::unique_lock<std::mutex> guard(victim.mutex, std::try_to_lock);
+		if (guard.owns_lock() && !victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void Executor::OffloadAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+	executor.submit([this, coroutine]
+	{
+		try
+		{
+			work();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		loop.post(coroutine);
+	});
+}
\ No newline at end of file
@@ -4,8 +4,8 @@
 #include <ctime>
 #include <utility>
 
-Game::Game(std::unique_ptr<Repository<Prompt>> promptRepository,
-		   std::unique_ptr<Repository<StatementCard>> statementCardRepository,
+Game::Game(std::shared_ptr<Repository<Prompt>> promptRepository,
+		   std::shared_ptr<Repository<StatementCard>> statementCardRepository,
 		   std::unique_ptr<GameDataManager> dataManager,
 		   const GameConfiguration& configuration) :
 	promptRepository{ std::move(promptRepository) },
@@ -22,8 +22,8 @@ void Game::generateRoundData()
 	// generate a tsar index
 	state.currentTsarIndex = dataManager->generatePlayerIndex(configuration.numOfPlayers);
 	// generate a new prompt
-	int promptIndex = dataManager->generateUniqueRepositoryIndex("prompt", promptRepository->size());
-	state.currentPrompt = promptRepository->getObject(promptIndex);
+	state.currentPromptId = dataManager->generateUniqueRepositoryIndex("prompt", promptRepository->size());
+	state.currentPrompt = promptRepository->getObject(state.currentPromptId);
 	// generate new statement cards in the place of the ones that have been used for all players
 	for (int playerIndex = 0; playerIndex < configuration.numOfPlayers; playerIndex++)
 	{
@@ -35,9 +35,70 @@ void Game::generateRoundData()
 				{
 					int cardIndex = dataManager->generateUniqueRepositoryIndex("statementCard", statementCardRepository->size());
 					state.usedStatementCards[playerIndex][usedCardFlagIndex] = false;
+					state.statementCardIds[playerIndex][usedCardFlagIndex] = cardIndex;
 					state.statementCards[playerIndex][usedCardFlagIndex] = statementCardRepository->getObject(cardIndex).text;
 				}
 			}
 		}
 	}
+}
+
+void Game::saveState(SnapshotWriter& writer) const
+{
+	writer.writeInt(configuration.numOfPlayers);
+	writer.writeInt(configuration.numOfStatementCards);
+	writer.writeInt(state.currentTsarIndex);
+	writer.writeInt(state.currentPromptId);
+	writer.writeString(state.currentPrompt.text);
+	writer.writeInt(state.currentPrompt.numOfBlanks);
+	for (int playerIndex = 0; playerIndex < configuration.numOfPlayers; playerIndex++)
+	{
+		for (int cardIndex = 0; cardIndex < configuration.numOfStatementCards; cardIndex++)
+		{
+			writer.writeString(state.statementCards[playerIndex][cardIndex]);
+			writer.writeInt(state.statementCardIds[playerIndex][cardIndex]);
+			writer.writeBool(state.usedStatementCards[playerIndex][cardIndex]);
+		}
+	}
+	dataManager->saveState(writer);
+}
+
+void Game::restoreState(SnapshotReader& reader)
+{
+	if (reader.readInt() != configuration.numOfPlayers || reader.readInt() != configuration.numOfStatementCards)
+	{
+		throw SnapshotException("Snapshot was taken with a different game configuration.");
+	}
+	state.currentTsarIndex = reader.readInt();
+	// card text lives in the repositories, the saved copy only confirms the deck still matches
+	state.currentPromptId = reader.readInt();
+	std::string promptText = reader.readString();
+	state.currentPrompt.numOfBlanks = reader.readInt();
+	state.currentPrompt.text = restoreText(*promptRepository, state.currentPromptId, promptText);
+	for (int playerIndex = 0; playerIndex < configuration.numOfPlayers; playerIndex++)
+	{
+		for (int cardIndex = 0; cardIndex < configuration.numOfStatementCards; cardIndex++)
+		{
+			std::string statementCardText = reader.readString();
+			state.statementCardIds[playerIndex][cardIndex] = reader.readInt();
+			state.usedStatementCards[playerIndex][cardIndex] = reader.readBool();
+			state.statementCards[playerIndex][cardIndex] = restoreText(*statementCardRepository, state.statementCardIds[playerIndex][cardIndex], statementCardText);
+		}
+	}
+	dataManager->restoreState(reader);
+}
+
+template<typename T>
+std::string_view Game::restoreText(Repository<T>& repository, int id, const std::string& savedText)
+{
+	// slots that were never dealt are saved empty
+	if (savedText.empty())
+	{
+		return std::string_view();
+	}
+	if (id < 0 || id >= repository.size() || repository.getObject(id).text != savedText)
+	{
+		throw SnapshotException("Snapshot was taken with a different deck.");
+	}
+	return repository.getObject(id).text;
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Interface.h"
+#include "Analytics.h"
+#include "Benchmark.h"
 #include "Exceptions.h"
+#include "Replay.h"
 
 #include <iostream>
 #include <sstream>
@@ -45,6 +48,16 @@ void Interface::printMessage(const std::string& message)
 	std::cout << message << '\n';
 }
 
+void Interface::printMessage(std::initializer_list<std::string_view> parts)
+{
+	std::lock_guard<std::mutex> guard(consoleGuard);
+	for (std::string_view part : parts)
+	{
+		std::cout << part;
+	}
+	std::cout << '\n';
+}
+
 bool Interface::isInputEmpty(const std::string& input)
 {
 	return input.length() == 0;
@@ -86,6 +99,9 @@ void Interface::setupCommands()
 	consoleCommands["exit"] = Command(InterfaceCommand(std::bind(&Interface::exit, this, std::placeholders::_1)), "exit", 0);
 	consoleCommands["echo"] = Command(InterfaceCommand(std::bind(&Interface::echo, this, std::placeholders::_1)), "echo", cmd::UNLIMITED_ARGUMENTS);
 	consoleCommands["start"] = Command(InterfaceCommand(std::bind(&Interface::startServer, this, std::placeholders::_1)), "start", 0);
+	consoleCommands["replay"] = Command(InterfaceCommand(std::bind(&Interface::replayEventLog, this, std::placeholders::_1)), "replay", 1);
+	consoleCommands["analyze"] = Command(InterfaceCommand(std::bind(&Interface::analyzeEventLog, this, std::placeholders::_1)), "analyze", 2);
+	consoleCommands["benchmark"] = Command(InterfaceCommand(std::bind(&Interface::runBenchmark, this, std::placeholders::_1)), "benchmark", 1);
 }
 
 void Interface::exit(const std::vector<std::string>& arguments)
@@ -103,4 +119,33 @@ void Interface::startServer(const std::vector<std::string>& arguments)
 {
 	server->start();
 	takingInput = false;
+}
+
+void Interface::replayEventLog(const std::vector<std::string>& arguments)
+{
+	try
+	{
+		Replay(*this).run(arguments[0]);
+	}
+	catch (EventLogException& exception)
+	{
+		printMessage(exception.what());
+	}
+}
+
+void Interface::analyzeEventLog(const std::vector<std::string>& arguments)
+{
+	try
+	{
+		Analytics(*this).run(arguments[0], arguments[1]);
+	}
+	catch (EventLogException& exception)
+	{
+		printMessage(exception.what());
+	}
+}
+
+void Interface::runBenchmark(const std::vector<std::string>& arguments)
+{
+	Benchmark(*this).run(arguments[0]);
 }
\ No newline at end of file
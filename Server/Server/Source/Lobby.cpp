@@ -0,0 +1,210 @@
+#include "Lobby.h"
+
+#include <algorithm>
+
+Lobby::Lobby(EventLoop& loop, int numOfPlayers, int minNumOfPlayers, std::chrono::milliseconds timeout) :
+	loop{ loop },
+	numOfPlayers{ numOfPlayers },
+	minNumOfPlayers{ minNumOfPlayers },
+	timeout{ timeout },
+	opened{ false },
+	partialTables(numOfPlayers + 1)
+{
+	deadline.callback = [this]{ expire(); };
+}
+
+Lobby::Players Lobby::close()
+{
+	opened = false;
+	deadline.cancel();
+	Players players;
+	for (Waiting& waiting : queue)
+	{
+		players.emplace_back(std::move(waiting.client));
+	}
+	queue.clear();
+	for (Bucket& bucket : partialTables)
+	{
+		for (auto& table : bucket)
+		{
+			std::move(table->players.begin(), table->players.end(), std::back_inserter(players));
+		}
+		bucket.clear();
+	}
+	seats.clear();
+	return players;
+}
+
+void Lobby::join(std::shared_ptr<Client> client)
+{
+	// the fullest partial table is the one closest to being dealt
+	for (int openSeats = 1; openSeats < numOfPlayers; openSeats++)
+	{
+		if (!partialTables[openSeats].empty())
+		{
+			sit(*partialTables[openSeats].front(), std::move(client));
+			return;
+		}
+	}
+	const Client* key = client.get();
+	queue.push_back(Waiting{ std::move(client), TimerWheel::Clock::now() });
+	seats[key] = Seat{ std::prev(queue.end()), nullptr };
+	if (queue.size() == numOfPlayers)
+	{
+		formTable();
+	}
+	else if (queue.size() == 1)
+	{
+		armDeadline();
+	}
+}
+
+bool Lobby::leave(const Client& client)
+{
+	auto seat = seats.find(&client);
+	if (seat == seats.end())
+	{
+		return false;
+	}
+	PartialTable* table = seat->second.table;
+	if (!table)
+	{
+		bool wasHead = seat->second.queued == queue.begin();
+		queue.erase(seat->second.queued);
+		seats.erase(seat);
+		if (wasHead)
+		{
+			armDeadline();
+		}
+		return true;
+	}
+	seats.erase(seat);
+	auto player = std::find_if(table->players.begin(), table->players.end(), [&client](auto& player){ return player.get() == &client; });
+	std::swap(*player, table->players.back());
+	table->players.pop_back();
+	if (table->players.size() < minNumOfPlayers)
+	{
+		requeue(*table);
+	}
+	else
+	{
+		moveToBucket(*table);
+	}
+	return true;
+}
+
+void Lobby::formTable()
+{
+	Players players;
+	for (int i = 0; i < numOfPlayers; i++)
+	{
+		seats.erase(queue.front().client.get());
+		players.emplace_back(std::move(queue.front().client));
+		queue.pop_front();
+	}
+	armDeadline();
+	onTableFormed(std::move(players));
+}
+
+void Lobby::expire()
+{
+	if (queue.size() >= minNumOfPlayers)
+	{
+		// everyone waiting sits down together, latecomers fill the open seats
+		Bucket& bucket = partialTables[numOfPlayers - queue.size()];
+		PartialTable& table = **bucket.insert(bucket.end(), std::make_unique<PartialTable>());
+		table.bucket = numOfPlayers - queue.size();
+		table.position = std::prev(bucket.end());
+		for (Waiting& waiting : queue)
+		{
+			seats[waiting.client.get()] = Seat{ queue.end(), &table };
+			table.players.emplace_back(std::move(waiting.client));
+		}
+		queue.clear();
+		table.fillDeadline.callback = [this, &table]{ deal(table); };
+		loop.timers().schedule(table.fillDeadline, std::chrono::milliseconds(lobby::FILL_TIMEOUT_MILLISECONDS));
+		return;
+	}
+	// the head has waited long enough, so has everyone who joined in the same tick
+	Players expired;
+	auto now = TimerWheel::Clock::now();
+	do
+	{
+		seats.erase(queue.front().client.get());
+		expired.emplace_back(std::move(queue.front().client));
+		queue.pop_front();
+	}
+	while (!queue.empty() && queue.front().since + timeout <= now);
+	armDeadline();
+	onExpired(std::move(expired));
+}
+
+void Lobby::armDeadline()
+{
+	if (queue.empty())
+	{
+		deadline.cancel();
+		return;
+	}
+	auto remaining = std::chrono::ceil<std::chrono::milliseconds>(queue.front().since + timeout - TimerWheel::Clock::now());
+	loop.timers().schedule(deadline, std::max(remaining, std::chrono::milliseconds(0)));
+}
+
+void Lobby::sit(PartialTable& table, std::shared_ptr<Client> client)
+{
+	seats[client.get()] = Seat{ queue.end(), &table };
+	table.players.emplace_back(std::move(client));
+	if (getOpenSeats(table) == 0)
+	{
+		deal(table);
+	}
+	else
+	{
+		moveToBucket(table);
+	}
+}
+
+void Lobby::moveToBucket(PartialTable& table)
+{
+	// splicing keeps the table where it is in memory, only its list node changes lists
+	Bucket& bucket = partialTables[getOpenSeats(table)];
+	bucket.splice(bucket.end(), partialTables[table.bucket], table.position);
+	table.bucket = getOpenSeats(table);
+}
+
+void Lobby::deal(PartialTable& table)
+{
+	if (table.players.size() < minNumOfPlayers)
+	{
+		requeue(table);
+		return;
+	}
+	for (auto& player : table.players)
+	{
+		seats.erase(player.get());
+	}
+	Players players = std::move(table.players);
+	retire(table);
+	onTableFormed(std::move(players));
+}
+
+void Lobby::requeue(PartialTable& table)
+{
+	// too few are left to play, they wait at the head of the queue again as if they had just joined
+	auto now = TimerWheel::Clock::now();
+	for (auto player = table.players.rbegin(); player != table.players.rend(); player++)
+	{
+		const Client* key = player->get();
+		queue.push_front(Waiting{ std::move(*player), now });
+		seats[key] = Seat{ queue.begin(), nullptr };
+	}
+	retire(table);
+	armDeadline();
+}
+
+void Lobby::retire(PartialTable& table)
+{
+	table.fillDeadline.cancel();
+	retiredTable = std::move(*table.position);
+	partialTables[table.bucket].erase(table.position);
+}
\ No newline at end of file
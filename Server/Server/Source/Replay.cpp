@@ -0,0 +1,185 @@
+#include "Replay.h"
+#include "EventLog.h"
+#include "Exceptions.h"
+#include "GameDataManager.h"
+#include "Interface.h"
+#include "SeededGenerator.h"
+
+#include <chrono>
+
+Replay::Replay(Interface& userInterface) :
+	userInterface{ userInterface },
+	numOfGames{ 0 },
+	numOfEvents{ 0 },
+	numOfDivergences{ 0 }
+{
+
+}
+
+void Replay::run(const std::string& eventLogFilepath)
+{
+	auto start = std::chrono::steady_clock::now();
+	EventLogReader records(eventLogFilepath);
+	try
+	{
+		while (records.next())
+		{
+			ReplayedGame& game = games[records.getTable()];
+			if (records.getType() != EventType::GameStarted && !game.game)
+			{
+				if (game.skipping)
+				{
+					continue;
+				}
+				throw SnapshotException("Event before the start of a game.");
+			}
+			SnapshotReader event = records.getEvent();
+			switch (records.getType())
+			{
+				case EventType::GameStarted: startGame(game, event); break;
+				case EventType::RoundDealt: checkRoundDealt(game, event); break;
+				case EventType::CardsSubmitted: applyCardsSubmitted(game, event); break;
+				case EventType::WinnerChosen: applyWinnerChosen(game, event); break;
+				case EventType::GameEnded: checkGameEnded(game, event); break;
+				default: throw SnapshotException("Unknown event type.");
+			}
+			numOfEvents++;
+		}
+		if (records.isTruncated())
+		{
+			userInterface.printMessage("Event log ends in a partial event, stopping there.");
+		}
+	}
+	catch (SnapshotException& exception)
+	{
+		userInterface.printMessage("Corrupt event log at byte " + std::to_string(records.getRecordOffset()) + ": " + exception.what());
+	}
+	auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	userInterface.printMessage("Replayed " + std::to_string(numOfGames) + " games, " + std::to_string(numOfEvents) + " events in " +
+		std::to_string(static_cast<int>(elapsed * 1000)) + " ms (" + std::to_string(static_cast<long long>(numOfEvents / elapsed)) + " events/s)");
+	userInterface.printMessage(numOfDivergences == 0 ? "No divergences." : std::to_string(numOfDivergences) + " divergences.");
+}
+
+void Replay::startGame(ReplayedGame& game, SnapshotReader& event)
+{
+	GameStartedEvent started(event);
+
+	std::shared_ptr<const Deck>& deck = decks[std::make_pair(started.promptRepoFilepaths, started.statementCardRepoFilepaths)];
+	if (!deck)
+	{
+		deck = std::make_shared<const Deck>(0, started.promptRepoFilepaths, started.statementCardRepoFilepaths);
+	}
+	game.number = ++numOfGames;
+	game.game.reset();
+	// decks that have since been deleted or edited can't deal the same cards, the game's events are passed over
+	game.skipping = true;
+	if (deck->getPrompts()->size() == 0 || deck->getStatementCards()->size() == 0)
+	{
+		reportDivergence(game, "decks " + started.promptRepoFilepaths + " / " + started.statementCardRepoFilepaths + " can't be loaded, skipping the game");
+		return;
+	}
+	if (started.hasDeckVersion && started.deckFingerprint != deck->getFingerprint())
+	{
+		reportDivergence(game, "decks " + started.promptRepoFilepaths + " / " + started.statementCardRepoFilepaths + " changed since version " +
+			std::to_string(started.deckVersion) + " the game was played with, skipping the game");
+		return;
+	}
+	game.skipping = false;
+
+	std::unique_ptr<GameDataManager> manager(new GameDataManager(std::unique_ptr<GeneratorStrategy>(new SeededGenerator(started.seed))));
+	game.game = std::unique_ptr<Game>(new Game(deck->getPrompts(), deck->getStatementCards(), std::move(manager),
+											   GameConfiguration(started.numOfPlayers, started.numOfRounds, started.numOfStatementCards)));
+	game.scores.assign(started.numOfPlayers, 0);
+}
+
+void Replay::checkRoundDealt(ReplayedGame& game, SnapshotReader& event)
+{
+	try
+	{
+		game.game->generateRoundData();
+	}
+	catch (DeckException& exception)
+	{
+		// an older log that doesn't record its deck, dealt from files that have since shrunk
+		reportDivergence(game, std::string(exception.what()) + " Skipping the rest of the game");
+		game.game.reset();
+		game.skipping = true;
+		return;
+	}
+	const GameState& state = game.game->getGameState();
+	int round = event.readInt();
+	bool matches = event.readInt() == state.currentTsarIndex;
+	matches = event.readInt() == state.currentPromptId && matches;
+	for (auto& playerStatementCardIds : state.statementCardIds)
+	{
+		for (int cardId : playerStatementCardIds)
+		{
+			matches = event.readInt() == cardId && matches;
+		}
+	}
+	if (!matches)
+	{
+		reportDivergence(game, "round #" + std::to_string(round + 1) + " was dealt differently");
+	}
+}
+
+void Replay::applyCardsSubmitted(ReplayedGame& game, SnapshotReader& event)
+{
+	int round = event.readInt();
+	int playerIndex = event.readInt();
+	event.readBool(); // autoplayed
+	int numOfChoices = event.readCount();
+	if (playerIndex < 0 || playerIndex >= game.scores.size())
+	{
+		throw SnapshotException("Player out of range.");
+	}
+	const std::vector<int>& cardIds = game.game->getStatementCardIdsOfPlayer(playerIndex);
+	for (int i = 0; i < numOfChoices; i++)
+	{
+		int choiceIndex = event.readInt();
+		int cardId = event.readInt();
+		if (choiceIndex < 0 || choiceIndex >= cardIds.size())
+		{
+			throw SnapshotException("Card choice out of range.");
+		}
+		if (cardIds[choiceIndex] != cardId)
+		{
+			reportDivergence(game, "round #" + std::to_string(round + 1) + " has a submission of a card that wasn't in the hand");
+		}
+		game.game->setPlayerStatementCardAsUsed(playerIndex, choiceIndex);
+	}
+}
+
+void Replay::applyWinnerChosen(ReplayedGame& game, SnapshotReader& event)
+{
+	event.readInt(); // round
+	int winnerIndex = event.readInt();
+	if (winnerIndex < 0 || winnerIndex >= game.scores.size())
+	{
+		throw SnapshotException("Winner out of range.");
+	}
+	game.scores[winnerIndex]++;
+}
+
+void Replay::checkGameEnded(ReplayedGame& game, SnapshotReader& event)
+{
+	for (int& score : game.scores)
+	{
+		if (event.readInt() != score)
+		{
+			reportDivergence(game, "final scores differ");
+			break;
+		}
+	}
+	game.game.reset();
+}
+
+void Replay::reportDivergence(const ReplayedGame& game, const std::string& description)
+{
+	numOfDivergences++;
+	if (numOfDivergences <= replay::MAX_REPORTED_DIVERGENCES)
+	{
+		userInterface.printMessage("Game #" + std::to_string(game.number) + ": " + description);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "SendQueue.h"
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cstring>
+
+SendQueue::SendQueue(EventLoop& loop, SocketHandle handle) :
+	loop{ loop },
+	handle{ handle },
+	closed{ false },
+	flushing{ false },
+	writeBlocked{ false },
+	closing{ false },
+	closeReason{ "Connection closed." },
+	chunks{ loop.memory() },
+	offset{ 0 },
+	queuedBytes{ 0 },
+	lowWatermark{ sendqueue::LOW_WATERMARK },
+	highWatermark{ sendqueue::HIGH_WATERMARK },
+	blockedSenders{ loop.memory() },
+	peakQueuedBytes{ 0 },
+	numOfStalls{ 0 }
+{
+	stallDeadline.callback = [this]{ close("Send queue stayed over the high watermark."); };
+}
+
+void SendQueue::push(const void* data, int size)
+{
+	if (closed)
+	{
+		throw ConnectionException(closeReason);
+	}
+	append(static_cast<const char*>(data), size);
+}
+
+void SendQueue::push(const WSABUF* buffers, int numOfBuffers)
+{
+	if (closed)
+	{
+		throw ConnectionException(closeReason);
+	}
+	// caller's buffer to go next and how much of it already went
+	int next = 0;
+	int taken = 0;
+	// no use trying while the flusher waits for the socket to take more
+	while (next < numOfBuffers && !writeBlocked)
+	{
+		// whatever is queued goes first, in the same WSASend as the message itself
+		WSABUF batch[sendqueue::MAX_BUFFERS_PER_SEND];
+		int numOfBatched = gatherQueued(batch);
+		int queuedBatchedBytes = 0;
+		for (int i = 0; i < numOfBatched; i++)
+		{
+			queuedBatchedBytes += batch[i].len;
+		}
+		int batchedBytes = queuedBatchedBytes;
+		for (int i = next; i < numOfBuffers && numOfBatched < sendqueue::MAX_BUFFERS_PER_SEND; i++)
+		{
+			int skipped = i == next ? taken : 0;
+			batch[numOfBatched].buf = buffers[i].buf + skipped;
+			batch[numOfBatched].len = buffers[i].len - skipped;
+			batchedBytes += batch[numOfBatched].len;
+			numOfBatched++;
+		}
+		DWORD sent = 0;
+		if (WSASend(handle, batch, numOfBatched, &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+		{
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+			{
+				close("send failed with error " + std::to_string(WSAGetLastError()));
+				throw ConnectionException(closeReason);
+			}
+			break;
+		}
+		int sentFromQueue = std::min<int>(sent, queuedBatchedBytes);
+		consume(sentFromQueue);
+		for (int left = sent - sentFromQueue; left > 0;)
+		{
+			int step = std::min<int>(left, buffers[next].len - taken);
+			left -= step;
+			taken += step;
+			if (taken == buffers[next].len)
+			{
+				next++;
+				taken = 0;
+			}
+		}
+		if (sent < batchedBytes)
+		{
+			break;
+		}
+	}
+	// only the part the socket didn't take is copied
+	for (; next < numOfBuffers; next++, taken = 0)
+	{
+		append(buffers[next].buf + taken, buffers[next].len - taken);
+	}
+}
+
+void SendQueue::close(const std::string& reason)
+{
+	if (closed)
+	{
+		return;
+	}
+	closed = true;
+	closeReason = reason;
+	stallDeadline.cancel();
+	chunks.clear();
+	offset = 0;
+	queuedBytes = 0;
+	loop.unwatch(handle);
+	closesocket(handle);
+	wakeSenders();
+}
+
+void SendQueue::closeWhenSent()
+{
+	if (flushing)
+	{
+		closing = true;
+	}
+	else
+	{
+		close("Connection closed.");
+	}
+}
+
+void SendQueue::setWatermarks(int lowWatermark, int highWatermark)
+{
+	this->lowWatermark = lowWatermark;
+	this->highWatermark = highWatermark;
+}
+
+void SendQueue::append(const char* data, int size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < size)
+	{
+		chunks.emplace_back().reserve(std::max(size, sendqueue::CHUNK_SIZE));
+	}
+	std::pmr::vector<char>& chunk = chunks.back();
+	chunk.resize(chunk.size() + size);
+	std::memcpy(chunk.data() + chunk.size() - size, data, size);
+
+	bool wasBelow = queuedBytes < highWatermark;
+	queuedBytes += size;
+	peakQueuedBytes = std::max(peakQueuedBytes, queuedBytes);
+	if (wasBelow && queuedBytes >= highWatermark)
+	{
+		numOfStalls++;
+		loop.timers().schedule(stallDeadline, std::chrono::milliseconds(sendqueue::STALL_TIMEOUT_MILLISECONDS));
+	}
+	if (!flushing)
+	{
+		// the flusher runs on the loop's next turn and takes everything queued until then
+		flushing = true;
+		loop.spawn(flush(shared_from_this()));
+	}
+}
+
+int SendQueue::gatherQueued(WSABUF* batch)
+{
+	int numOfBatched = 0;
+	for (auto chunk = chunks.begin(); chunk != chunks.end() && numOfBatched < sendqueue::MAX_BUFFERS_PER_SEND; chunk++)
+	{
+		int skipped = numOfBatched == 0 ? offset : 0;
+		batch[numOfBatched].buf = chunk->data() + skipped;
+		batch[numOfBatched].len = chunk->size() - skipped;
+		numOfBatched++;
+	}
+	return numOfBatched;
+}
+
+Task SendQueue::flush(std::shared_ptr<SendQueue> queue)
+{
+	WSABUF buffers[sendqueue::MAX_BUFFERS_PER_SEND];
+	while (!queue->closed && !queue->chunks.empty())
+	{
+		DWORD numOfBuffers = queue->gatherQueued(buffers);
+		DWORD sent = 0;
+		if (WSASend(queue->handle, buffers, numOfBuffers, &sent, 0, nullptr, nullptr) != SOCKET_ERROR)
+		{
+			queue->consume(sent);
+		}
+		else if (WSAGetLastError() == WSAEWOULDBLOCK)
+		{
+			queue->writeBlocked = true;
+			co_await queue->loop.writable(queue->handle);
+			queue->writeBlocked = false;
+		}
+		else
+		{
+			queue->close("send failed with error " + std::to_string(WSAGetLastError()));
+		}
+	}
+	queue->flushing = false;
+	if (queue->closing)
+	{
+		queue->close("Connection closed.");
+	}
+}
+
+void SendQueue::consume(int sent)
+{
+	queuedBytes -= sent;
+	offset += sent;
+	while (!chunks.empty() && offset >= chunks.front().size())
+	{
+		offset -= chunks.front().size();
+		chunks.pop_front();
+	}
+	if (queuedBytes <= lowWatermark)
+	{
+		stallDeadline.cancel();
+		wakeSenders();
+	}
+}
+
+void SendQueue::wakeSenders()
+{
+	for (std::coroutine_handle<> sender : blockedSenders)
+	{
+		loop.schedule(sender);
+	}
+	blockedSenders.clear();
+}
\ No newline at end of file
@@ -1,52 +1,60 @@
 #include "Interface.h"
 #include "Server.h"
-#include "FileRepository.h"
-#include "GameDataManager.h"
-#include "StdRandGenerator.h"
-#include "Repository.h"
 #include "WNetwok.h"
-#include "StatementCard.h"
-#include "GeneratorStrategy.h"
-#include "Prompt.h"
-#include "Game.h"
 
 #include <algorithm>
-#include <ctime>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <random>
+#include <thread>
 
 Server::Server(Interface& userInterface, const std::string& ip, short port, const std::string& settingsFilepath):
 	wsaManager{ WSAManager::GetInstance() },
+	executor{ std::make_shared<Executor>() },
 	listening{ Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) },
 	settingsFilepath{ settingsFilepath },
+	checkpointFilepath{ "checkpoint.bin" },
+	eventLogFilepath{ "events.log" },
+	tableSettings{ GameConfiguration(), std::chrono::seconds(60), TimeoutPolicy::AutoPlay, false },
+	lobbyTimeout{ std::chrono::minutes(10) },
+	minNumOfPlayers{ lobby::MIN_PLAYERS },
+	maxNumOfTables{ 1 },
+	numOfTablesDealt{ 0 },
+	nextTableNumber{ 1 },
+	numOfShards{ std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) },
+	accepting{ false },
+	sessionTokenGenerator{ std::random_device()() },
+	reloadingDecks{ false },
 	userInterface{ userInterface },
-	doneGenerating{ false },
-	dataSentCounter{ 0 },
-	receivedStatementCardChoicesCounter{ 0 },
-	shuffledStatementCards{ false },
-	sentStatementCardChoicesCounter{ 0 },
-	receivedTsarStatementCard{ false },
-	sentTsarStatementCardChoiceCounter{ 0 },
-	sentServerConfirmationCounter{ 0 },
-	receivedNextRoundConfirmationCounter{ 0 },
-	resetFlags{ false }
+	doorbell{ loop },
+	newestTableShard{ -1 },
+	stopping{ false },
+	checkpointSequence{ 0 },
+	lastWrittenCheckpoint{ -1 },
+	restoredEventLogSize{ -1 }
 {
 	loadSettings();
 	listening.Bind(IPv4Address(ip, port));
+	checkpointTimer.callback = [this]{ saveCheckpoint(); };
 }
 
 Server::~Server()
 {
-	
+	// checkpoint writes and offloaded work capture this, the workers must be done with it
+	// before any other member goes away
+	executor.reset();
 }
 
 void Server::loadSettings()
 {
 	std::ifstream settingsFile(settingsFilepath);
 	std::string settingType;
-	std::string statementCardRepoFilepath;
-	std::string promptRepoFilepath;
+	std::string statementCardRepoFilepaths;
+	std::string promptRepoFilepaths;
 	int numOfPlayers;
 	int numOfRounds;
 	int numOfStatementCards;
@@ -54,434 +62,562 @@ void Server::loadSettings()
 	settingsFile >> settingType >> numOfPlayers;
 	settingsFile >> settingType >> numOfRounds;
 	settingsFile >> settingType >> numOfStatementCards;
-	settingsFile >> settingType >> statementCardRepoFilepath;
-	settingsFile >> settingType >> promptRepoFilepath;
+	// either deck can be a comma separated list of expansion packs
+	settingsFile >> settingType >> statementCardRepoFilepaths;
+	settingsFile >> settingType >> promptRepoFilepaths;
+
+	// optional, older settings files stop here and keep the defaults
+	int phaseTimeoutSeconds = 0;
+	std::string policy;
+	int lobbyTimeoutSeconds = 0;
+	std::string checkpoint;
+	std::string events;
+	int minPlayers = 0;
+	int numOfTables = -1;
+	int shardCount = 0;
+	settingsFile >> settingType >> phaseTimeoutSeconds;
+	settingsFile >> settingType >> policy;
+	settingsFile >> settingType >> lobbyTimeoutSeconds;
+	settingsFile >> settingType >> checkpoint;
+	settingsFile >> settingType >> events;
+	settingsFile >> settingType >> minPlayers;
+	settingsFile >> settingType >> numOfTables;
+	settingsFile >> settingType >> shardCount;
+	if (phaseTimeoutSeconds > 0)
+	{
+		tableSettings.phaseTimeout = std::chrono::seconds(phaseTimeoutSeconds);
+	}
+	if (!policy.empty())
+	{
+		tableSettings.timeoutPolicy = parseTimeoutPolicy(policy);
+	}
+	if (lobbyTimeoutSeconds > 0)
+	{
+		lobbyTimeout = std::chrono::seconds(lobbyTimeoutSeconds);
+	}
+	if (!checkpoint.empty())
+	{
+		checkpointFilepath = checkpoint;
+	}
+	if (!events.empty())
+	{
+		eventLogFilepath = events;
+	}
+	if (minPlayers > 0)
+	{
+		minNumOfPlayers = minPlayers;
+	}
+	if (numOfTables >= 0)
+	{
+		maxNumOfTables = numOfTables;
+	}
+	if (shardCount > 0)
+	{
+		numOfShards = shardCount;
+	}
+	// a round needs a tsar and somebody to judge
+	minNumOfPlayers = std::clamp(minNumOfPlayers, 2, numOfPlayers);
 
 	userInterface.printMessage("Game initialized with " + std::to_string(numOfPlayers) + " players, playing for " + std::to_string(numOfRounds) + " rounds");
-	userInterface.printMessage("Read answers from " + statementCardRepoFilepath);
-	userInterface.printMessage("Read questions from " + promptRepoFilepath);
-
-	std::unique_ptr<Repository<Prompt>> promptRepository = std::unique_ptr<Repository<Prompt>>(new FileRepository<Prompt>(promptRepoFilepath));
-	std::unique_ptr<Repository<StatementCard>> statementCardRepository =
-		std::unique_ptr<Repository<StatementCard>>(new FileRepository<StatementCard>(statementCardRepoFilepath));
-	std::unique_ptr<GeneratorStrategy> strategy = std::unique_ptr<StdRandGenerator>(new StdRandGenerator());
-	std::unique_ptr<GameDataManager> manager = std::unique_ptr<GameDataManager>(new GameDataManager(std::move(strategy)));
-	GameConfiguration configuration(numOfPlayers, numOfRounds, numOfStatementCards);
-
-	game = std::unique_ptr<Game>(new Game(std::move(promptRepository), std::move(statementCardRepository),
-										  std::move(manager), configuration));
+	if (maxNumOfTables != 1)
+	{
+		userInterface.printMessage(maxNumOfTables == 0 ? std::string("Dealing tables until stopped") : "Dealing up to " + std::to_string(maxNumOfTables) + " tables");
+	}
+	if (numOfShards > 1)
+	{
+		userInterface.printMessage("Playing tables on " + std::to_string(numOfShards) + " threads");
+	}
+	userInterface.printMessage("Read answers from " + statementCardRepoFilepaths);
+	userInterface.printMessage("Read questions from " + promptRepoFilepaths);
+
+	decks = std::make_shared<DeckLibrary>(promptRepoFilepaths, statementCardRepoFilepaths);
+	tableSettings.configuration = GameConfiguration(numOfPlayers, numOfRounds, numOfStatementCards);
+}
+
+void Server::watchDecks()
+{
+	if (!reloadingDecks && decks->checkForChanges())
+	{
+		reloadingDecks = true;
+		loop.spawn(reloadDecks());
+	}
+	loop.timers().schedule(deckWatch, std::chrono::milliseconds(deck::POLL_INTERVAL_MILLISECONDS));
+}
+
+Task Server::reloadDecks()
+{
+	try
+	{
+		co_await executor->offload(loop, [this]{ decks->reload(); });
+		userInterface.printMessage("Loaded deck version " + std::to_string(decks->current()->getVersion()) + ", new games will be dealt from it.");
+	}
+	catch (DeckException& exception)
+	{
+		userInterface.printMessage(exception.what());
+	}
+	reloadingDecks = false;
 }
 
 void Server::start()
 {
+	listening.SetBacklog(acceptor::LISTEN_BACKLOG);
 	listening.Listen();
-	acceptConnections();
-	userInterface.printMessage("All players connected. Starting game.");
-	for (int i = 0; i < clients.size(); i++)
+	accepting = true;
+	for (int i = 0; i < numOfShards; i++)
 	{
-		sendPlayerIDToClient(i);
-		sendPlayerListToClient(i);
-		sendNumOfRoundsToClient(i);
-		sendNumOfStatementCardsToClient(i);
+		shards.emplace_back(std::make_unique<Shard>(i, numOfShards, loop, doorbell, *executor, userInterface, decks, tableSettings, minNumOfPlayers, lobbyTimeout));
+		shardStatus.emplace_back(ShardStatus{ 0, 0, false });
+	}
+	restoreCheckpoint();
+	startShards();
+	try
+	{
+		eventLog.open(eventLogFilepath, restoredEventLogSize);
+		if (eventLog.size() < restoredEventLogSize)
+		{
+			userInterface.printMessage("Event log " + eventLogFilepath + " lost events before the checkpoint, the games can't be replayed.");
+		}
 	}
-	masterThread = std::thread(&Server::gameLogic, this);
-	sendClientThreads.resize(clients.size());
-	receiveClientThreads.resize(clients.size());
-	for (int i = 0; i < clients.size(); i++)
+	catch (EventLogException& exception)
 	{
-		sendClientThreads[i] = std::thread(&Server::sendClient, this, i);
-		receiveClientThreads[i] = std::thread(&Server::receiveClient, this, i);
+		userInterface.printMessage(exception.what());
 	}
-	for (int i = 0; i < clients.size(); i++)
+	deckWatch.callback = [this]{ watchDecks(); };
+	loop.timers().schedule(deckWatch, std::chrono::milliseconds(deck::POLL_INTERVAL_MILLISECONDS));
+	loop.spawn(receiveReports());
+	loop.spawn(acceptConnections());
+	loop.run();
+	for (auto& shard : shards)
 	{
-		sendClientThreads[i].join();
-		receiveClientThreads[i].join();
+		shard->join();
+	}
+	shards.clear();
+	eventLog.close();
+	if (numOfTablesDealt > 0)
+	{
+		discardCheckpoint();
+	}
+}
+
+void Server::startShards()
+{
+	// the tables left to deal are split up front, so the shards can't deal more between them than allowed
+	int remaining = std::max(maxNumOfTables - numOfTablesDealt, 0);
+	for (int i = 0; i < numOfShards; i++)
+	{
+		int tableQuota = -1;
+		if (maxNumOfTables > 0)
+		{
+			tableQuota = remaining / numOfShards + (i < remaining % numOfShards ? 1 : 0);
+		}
+		shardStatus[i].lobbyOpen = tableQuota != 0;
+		shards[i]->start(nextTableNumber, tableQuota);
 	}
-	masterThread.join();
-	auto winner = std::max_element(clients.begin(), clients.end(), [](auto& client1, auto& client2){ return client1->getScore() < client2->getScore(); });
-	userInterface.printMessage(winner->get()->getUsername());
 }
 
-void Server::acceptConnections()
+Task Server::receiveReports()
 {
-	while (clients.size() < game->getGameConfiguration().numOfPlayers)
+	ShardReport report;
+	while (!stopping)
 	{
-		try
+		for (auto& shard : shards)
 		{
-			FileDescriptorSet set;
-			set.Zero();
-			set.AddSocket(listening);
-			set.SetTimeout(1, 0);
-			if (set.Select() > 0)
+			while (!stopping && shard->receive(report))
 			{
-				std::unique_ptr<Client> client(std::make_unique<Client>());
-				listening.Accept(client->getSocket(), client->getAddress());
-				receiveUsernameFromClient(client);
-				if (validUsername(client))
+				switch (report.type)
 				{
-					userInterface.printMessage(client->getUsername() + " joined!");
-					clients.emplace_back(std::move(client));
+					case ShardReportType::Left: releasePlayers(report); break;
+					case ShardReportType::LobbyExpired: releasePlayers(report); closeLobbiesIfNobodyGotATable(); break;
+					case ShardReportType::TableDealt: addTable(report); break;
+					case ShardReportType::RoundEnded: saveTableState(report); break;
+					case ShardReportType::GameEnded: endGame(report); break;
+					case ShardReportType::LobbyClosed: closeLobby(report); break;
 				}
 			}
 		}
-		catch (WinSockException& exception)
+		if (!stopping)
 		{
-			userInterface.printMessage(exception.what());
+			co_await doorbell.wait();
 		}
 	}
-}
-
-void Server::gameLogic()
-{
-	srand(time(0));
-	for (int i = 0; i < game->getGameConfiguration().numOfRounds; i++)
+	// the stop commands go out from this loop, it has to keep running until none is held back
+	while (std::any_of(shards.begin(), shards.end(), [](auto& shard){ return shard->hasCommandsHeldBack(); }))
 	{
-		generateData_();
-		shuffleStatementCards_();
-		resetData_();
+		co_await loop.sleep(std::chrono::milliseconds(mailbox::RETRY_MILLISECONDS));
 	}
 }
 
-void Server::sendClient(int clientIndex)
+void Server::releasePlayers(const ShardReport& report)
 {
-	for (int i = 0; i < game->getGameConfiguration().numOfRounds; i++)
+	shardStatus[report.shard].waiting -= report.usernames.size();
+	for (auto& username : report.usernames)
 	{
-		sendData_(clientIndex);
-		sendStatementCardChoices_(clientIndex);
-		sendTsarChoice_(clientIndex);
-		sendConfirmation_(clientIndex);
+		usernames.release(username);
 	}
 }
 
-void Server::receiveClient(int clientIndex)
+void Server::closeLobbiesIfNobodyGotATable()
 {
-	for (int i = 0; i < game->getGameConfiguration().numOfRounds; i++)
+	// a server dealing a fixed number of tables gives up when nobody ever got a table
+	if (maxNumOfTables == 0 || numOfTablesDealt > 0 || std::any_of(shardStatus.begin(), shardStatus.end(), [](auto& status){ return status.waiting > 0; }))
 	{
-		receiveData_(clientIndex);
-		receiveConfirmation_(clientIndex);
+		return;
 	}
-}
-
-void Server::receiveStatementCardChoiceFromClient(int clientIndex)
-{
-	int choiceIndex;
-	int statementCardTextLength;
-	std::string statementCard;
-	std::vector<std::string> statementCards;
-	for (int i = 0; i < game->getGameState().currentPrompt.numOfBlanks; i++)
-	{
-		Socket socket = clients[clientIndex]->getSocket();
-		socket.Receive(&choiceIndex, sizeof(int));
-		game->setPlayerStatementCardAsUsed(clientIndex, choiceIndex);
-		socket.Receive(&statementCardTextLength, sizeof(int));
-		statementCard.resize(statementCardTextLength);
-		socket.Receive(&statementCard[0], statementCardTextLength);
-		statementCards.emplace_back(statementCard);
-	}
-	playerStatementCardChoices[clientIndex] = std::pair<int, std::vector<std::string>>(clientIndex, statementCards);
-}
-
-void Server::receiveStatementCardChoiceFromTsar(int clientIndex)
-{
-	Socket socket = clients[clientIndex]->getSocket();
-	socket.Receive(&tsarChoiceIndex, sizeof(int));
-	clients[playerStatementCardChoices[tsarChoiceIndex].first]->incrementScore();
-}
-
-void Server::receiveNextRoundConfirmationFromClient(int clientIndex)
-{
-	Socket socket = clients[clientIndex]->getSocket();
-	bool ready; 
-	socket.Receive(&ready, sizeof(bool));
-	// we don't care what the bool is set to, just that its received 
-}
-
-void Server::receiveUsernameFromClient(std::unique_ptr<Client>& client)
-{
-	int usernameLength;
-	std::string username;
-	client->getSocket().Receive(&usernameLength, sizeof(int));
-	username.resize(usernameLength);
-	client->getSocket().Receive(&username[0], usernameLength);
-	client->setUsername(username);
-}
-
-bool Server::validUsername(std::unique_ptr<Client>& client)
-{
-	auto socket = client->getSocket();
-	std::string username = client->getUsername();
-	bool valid = true;
-	for (int i = 0; i < clients.size() && valid; i++)
+	for (int i = 0; i < numOfShards; i++)
 	{
-		std::string clientUsername = clients[i]->getUsername();
-		if (clientUsername == username)
+		if (shardStatus[i].lobbyOpen)
 		{
-			valid = false;
+			shards[i]->send(ShardCommand{ ShardCommandType::CloseLobby, nullptr });
 		}
 	}
-	socket.Send(&valid, sizeof(bool));
-	return valid;
 }
 
-std::vector<std::string> Server::getPlayerList() const
+void Server::addTable(const ShardReport& report)
 {
-	std::vector<std::string> playerList;
-	for (auto& client : clients)
+	ShardStatus& status = shardStatus[report.shard];
+	status.waiting -= report.sessionTokens.size();
+	status.numOfTables++;
+	numOfTablesDealt++;
+	newestTableShard = report.shard;
+	for (SessionToken sessionToken : report.sessionTokens)
 	{
-		playerList.emplace_back(client->getUsername());
+		sessions[sessionToken] = report.shard;
 	}
-	return playerList;
-}
-
-void Server::sendPlayerIDToClient(int clientIndex)
-{
-	Socket socket = clients[clientIndex]->getSocket();
-	socket.Send(&clientIndex, sizeof(int));
 }
 
-void Server::sendPlayerListToClient(int clientIndex)
+void Server::saveTableState(ShardReport& report)
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	int numOfPlayers = clients.size();
-	socket.Send(&numOfPlayers, sizeof(int));
-	for (int i = 0; i < numOfPlayers; i++)
+	// the log and the checkpoints move on together, a log cut back to a checkpoint's size ends
+	// with the rounds its tables were saved after
+	eventLog.appendTableRecords(report.table, report.records);
+	tableCheckpoints[report.table] = std::move(report.data);
+	if (!checkpointTimer.isScheduled())
 	{
-		std::string username = clients[i]->getUsername();
-		int usernameLength = username.length();
-		socket.Send(&usernameLength, sizeof(int));
-		socket.Send(&username[0], usernameLength);
+		loop.timers().schedule(checkpointTimer, std::chrono::milliseconds(0));
 	}
 }
 
-void Server::sendNumOfRoundsToClient(int clientIndex)
+void Server::endGame(const ShardReport& report)
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	int numOfRounds = game->getGameConfiguration().numOfRounds;
-	socket.Send(&numOfRounds, sizeof(int));
-}
-
-void Server::sendNumOfStatementCardsToClient(int clientIndex)
-{
-	Socket socket = clients[clientIndex]->getSocket();
-	int numOfStatementCards = game->getGameConfiguration().numOfStatementCards;
-	socket.Send(&numOfStatementCards, sizeof(int));
+	eventLog.appendTableRecords(report.table, report.records);
+	for (SessionToken sessionToken : report.sessionTokens)
+	{
+		sessions.erase(sessionToken);
+	}
+	for (auto& username : report.usernames)
+	{
+		usernames.release(username);
+	}
+	tableCheckpoints.erase(report.table);
+	shardStatus[report.shard].numOfTables--;
+	saveCheckpoint();
+	stopIfIdle();
 }
 
-void Server::sendGeneratedTsarIndexToClient(int clientIndex)
+void Server::closeLobby(const ShardReport& report)
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	socket.Send(&(game->getGameState().currentTsarIndex), sizeof(int));
+	shardStatus[report.shard].lobbyOpen = false;
+	stopIfIdle();
 }
 
-void Server::sendGeneratedPromptToClient(int clientIndex)
+void Server::stopIfIdle()
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	std::string prompt = game->getGameState().currentPrompt.text;
-	int promptNumOfBlanks = game->getGameState().currentPrompt.numOfBlanks;
-	int promptTextLength = prompt.length();
-	socket.Send(&promptTextLength, sizeof(int));
-	socket.Send(&prompt[0], promptTextLength);
-	socket.Send(&promptNumOfBlanks, sizeof(int));
+	if (std::any_of(shardStatus.begin(), shardStatus.end(), [](auto& status){ return status.lobbyOpen || status.numOfTables > 0; }))
+	{
+		return;
+	}
+	// lets the acceptor and the shards' readers finish so the loops can run out of tasks
+	stopAccepting();
+	stopping = true;
+	for (auto& shard : shards)
+	{
+		shard->send(ShardCommand{ ShardCommandType::Stop, nullptr });
+	}
 }
 
-void Server::sendGeneratedStatementCardsToClient(int clientIndex)
+void Server::stopAccepting()
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	auto statementCards = game->getGameState().statementCards[clientIndex];
-	int numOfStatementCards = statementCards.size();
-	socket.Send(&numOfStatementCards, sizeof(int));
-	for (int i = 0; i < statementCards.size(); i++)
-	{
-		int statementCardLength = statementCards[i].length();
-		socket.Send(&statementCardLength, sizeof(int));
-		socket.Send(&statementCards[i][0], statementCardLength);
-	}
+	accepting = false;
+	// wakes acceptConnections so it can notice
+	loop.unwatch(listening.GetHandle());
 }
 
-void Server::sendStatementCardChoicesToClient(int clientIndex)
+Task Server::acceptConnections()
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	int numOfChoices = clients.size() - 1; // tsar doesn't choose
-	socket.Send(&numOfChoices, sizeof(int));
-	for (int i = 0; i < clients.size(); i++)
+	// the listening socket is polled with everything else, so handshakes and the shards' reports are
+	// taken meanwhile; it stays open during the game for players resuming their session. This one
+	// acceptor hands every connection to a shard once its handshake was read, Winsock can't spread
+	// accepts over listeners of their own with SO_REUSEPORT
+	SocketHandle handle = listening.GetHandle();
+	u_long nonBlocking = 1;
+	ioctlsocket(handle, FIONBIO, &nonBlocking);
+	std::unique_ptr<Client> client;
+	while (accepting)
 	{
-		if (i != game->getGameState().currentTsarIndex)
+		co_await loop.readable(handle);
+		// a join storm is taken in batches instead of one connection per poll
+		for (int i = 0; i < acceptor::MAX_ACCEPTS_PER_WAKEUP && accepting; i++)
 		{
-			for (int j = 0; j < game->getGameState().currentPrompt.numOfBlanks; j++)
+			try
 			{
-				try
+				// kept when nothing was pending, the next wakeup reuses it
+				if (!client)
 				{
-					int statementCardTextLength = playerStatementCardChoices[i].second[j].length();
-					socket.Send(&statementCardTextLength, sizeof(int));
-					socket.Send(&playerStatementCardChoices[i].second[j][0], statementCardTextLength);
+					client = std::make_unique<Client>();
 				}
-				catch (WinSockException& exception)
+				listening.Accept(client->getSocket(), client->getAddress());
+				client->setConnection(std::make_unique<AsyncSocket>(loop, client->getSocket().GetHandle()));
+				loop.spawn(handshake(std::move(client)));
+			}
+			catch (WinSockException& exception)
+			{
+				if (WSAGetLastError() != WSAEWOULDBLOCK)
 				{
 					userInterface.printMessage(exception.what());
 				}
+				break;
+			}
+			catch (ConnectionException& exception)
+			{
+				userInterface.printMessage(exception.what());
+				client.reset();
 			}
 		}
 	}
 }
 
-void Server::sendTsarStatementCardChoiceToClient(int clientIndex)
+Task Server::handshake(std::unique_ptr<Client> client)
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	socket.Send(&playerStatementCardChoices[tsarChoiceIndex].first, sizeof(int));
-	socket.Send(&tsarChoiceIndex, sizeof(int));
+	// a connection that never identifies itself would otherwise hold a lobby slot hostage
+	AsyncSocket& connection = client->getConnection();
+	Timer handshakeDeadline;
+	handshakeDeadline.callback = [&connection]{ connection.close(); };
+	loop.timers().schedule(handshakeDeadline, std::chrono::milliseconds(protocol::HANDSHAKE_TIMEOUT_MILLISECONDS));
+	bool accepted = false;
+	try
+	{
+		int handshakeType;
+		co_await connection.receive(&handshakeType, sizeof(int));
+		if (handshakeType == static_cast<int>(HandshakeType::Resume))
+		{
+			co_await resumeSession(client, accepted);
+		}
+		else if (handshakeType == static_cast<int>(HandshakeType::Spectate))
+		{
+			co_await watchTable(client, accepted);
+		}
+		else
+		{
+			co_await joinLobby(client, accepted);
+		}
+	}
+	catch (ConnectionException& exception)
+	{
+		userInterface.printMessage("Handshake failed: " + std::string(exception.what()));
+	}
+	handshakeDeadline.cancel();
+	// an accepted connection belongs to its shard now, which answers it
+	if (!accepted)
+	{
+		// a refused peer still gets its answer
+		connection.closeAfterSending();
+	}
 }
 
-void Server::sendServerConfirmationToClient(int clientIndex)
+Task Server::joinLobby(std::unique_ptr<Client>& client, bool& accepted)
 {
-	Socket socket = clients[clientIndex]->getSocket();
-	bool confirmation;
-	socket.Send(&confirmation, sizeof(bool));
+	AsyncSocket& connection = client->getConnection();
+	co_await receiveUsernameFromClient(*client);
+	int shard = placeJoiner();
+	accepted = shard >= 0 && usernames.reserve(client->getUsername());
+	if (!accepted)
+	{
+		co_await connection.send(&accepted, sizeof(bool));
+		co_return;
+	}
+	client->setSessionToken(sessionTokenGenerator());
+	shardStatus[shard].waiting++;
+	handOver(shard, ShardCommandType::Join, std::move(client));
 }
 
-void Server::resetData()
+Task Server::resumeSession(std::unique_ptr<Client>& client, bool& accepted)
 {
-	doneGenerating = false;
-	dataSentCounter = 0;
-	receivedStatementCardChoicesCounter = 0;
-	shuffledStatementCards = false;
-	sentStatementCardChoicesCounter = 0;
-	receivedTsarStatementCard = false;
-	sentTsarStatementCardChoiceCounter = 0;
-	sentServerConfirmationCounter = 0;
-	receivedNextRoundConfirmationCounter = 0;
-	resetFlags = false;
-	playerStatementCardChoices.clear();
+	AsyncSocket& connection = client->getConnection();
+	SessionToken sessionToken;
+	co_await connection.receive(&sessionToken, sizeof(SessionToken));
+	auto session = sessions.find(sessionToken);
+	accepted = accepting && session != sessions.end();
+	if (!accepted)
+	{
+		co_await connection.send(&accepted, sizeof(bool));
+		co_return;
+	}
+	client->setSessionToken(sessionToken);
+	handOver(session->second, ShardCommandType::Resume, std::move(client));
 }
 
-void Server::generateData_()
+Task Server::watchTable(std::unique_ptr<Client>& client, bool& accepted)
 {
-	game->generateRoundData();
-	int tsarIndex = game->getGameState().currentTsarIndex;
-	userInterface.printMessage("Tsar Index: " + std::to_string(tsarIndex));
-	doneGenerating = true;
-	doneGeneratingCvar.notify_all();
+	AsyncSocket& connection = client->getConnection();
+	accepted = accepting;
+	if (!accepted)
+	{
+		co_await connection.send(&accepted, sizeof(bool));
+		co_return;
+	}
+	// the newest table is the one most of its game is left to watch; before there is one, the
+	// spectator waits where the next joiner would go
+	int shard = newestTableShard >= 0 ? newestTableShard : std::max(placeJoiner(), 0);
+	handOver(shard, ShardCommandType::Spectate, std::move(client));
 }
 
-void Server::shuffleStatementCards_()
+Task Server::receiveUsernameFromClient(Client& client)
 {
-	std::unique_lock<std::mutex> receivedStatementCardChoicesLock(receivedStatementCardChoicesMutex);
-	resetFlags = false;
-	receivedStatementCardChoicesCvar.wait(receivedStatementCardChoicesLock, [this]{ return receivedStatementCardChoicesCounter == clients.size() - 1; });
-	receivedStatementCardChoicesLock.unlock();
-
-	//std::random_shuffle(playerStatementCardChoices.begin(), playerStatementCardChoices.end(), [](int i){ return rand() % i; });
-	shuffledStatementCards = true;
-	shuffledStatementCardsCvar.notify_all();
+	std::string username;
+	co_await client.getConnection().receiveString(username);
+	client.setUsername(username);
 }
 
-void Server::resetData_()
+void Server::handOver(int shard, ShardCommandType type, std::unique_ptr<Client> client)
 {
-	std::unique_lock<std::mutex> sentServerConfirmationLock(sentServerConfirmationMutex);
-	sentServerConfirmationCvar.wait(sentServerConfirmationLock, [this]{ return sentServerConfirmationCounter == clients.size(); });
-	sentServerConfirmationLock.unlock();
-
-	resetData();
-	resetFlags = true;
-	resetFlagsCvar.notify_all();
+	// nothing is pending on the connection once its handshake was read, the shard sets it up
+	// again on its own loop and answers the handshake from there
+	client->detachConnection();
+	shards[shard]->send(ShardCommand{ type, std::move(client) });
 }
 
-void Server::sendData_(int clientIndex)
+int Server::placeJoiner() const
 {
-	std::unique_lock<std::mutex> doneGeneratingLock(doneGeneratingMutex);
-	doneGeneratingCvar.wait(doneGeneratingLock, [this]{ return doneGenerating; });
-	doneGeneratingLock.unlock();
-
-	int tsarIndex = game->getGameState().currentTsarIndex;
-	userInterface.printMessage("Sending data to " + clients[clientIndex]->getUsername());
-	sendGeneratedTsarIndexToClient(clientIndex);
-	sendGeneratedPromptToClient(clientIndex);
-	if (clientIndex != tsarIndex)
+	int numOfPlayers = tableSettings.configuration.numOfPlayers;
+	int placed = -1;
+	for (int i = 0; i < numOfShards; i++)
 	{
-		sendGeneratedStatementCardsToClient(clientIndex);
+		if (!shardStatus[i].lobbyOpen)
+		{
+			continue;
+		}
+		if (placed < 0)
+		{
+			placed = i;
+			continue;
+		}
+		// the lobby closest to dealing a table fills it up, a new one starts where the fewest tables are played
+		int seated = shardStatus[i].waiting % numOfPlayers;
+		int placedSeated = shardStatus[placed].waiting % numOfPlayers;
+		if (seated != placedSeated ? seated > placedSeated : shardStatus[i].numOfTables < shardStatus[placed].numOfTables)
+		{
+			placed = i;
+		}
 	}
-	dataSentCounter++;
-	dataSentCvar.notify_all();
+	return placed;
 }
 
-void Server::sendStatementCardChoices_(int clientIndex)
+void Server::saveCheckpoint()
 {
-	std::unique_lock<std::mutex> shuffledStatementCardsLock(shuffledStatementCardsMutex);
-	shuffledStatementCardsCvar.wait(shuffledStatementCardsLock, [this]{ return shuffledStatementCards; });
-	shuffledStatementCardsLock.unlock();
-
-	sendStatementCardChoicesToClient(clientIndex);
-	userInterface.printMessage("Sent player choices to " + clients[clientIndex]->getUsername());
-	sentStatementCardChoicesCounter++;
-	sentStatementCardChoicesCvar.notify_all();
+	// each table serialized itself between its rounds, only their latest states are put together here;
+	// the events logged up to them go to the log's writer now, not with its next full batch
+	eventLog.flush();
+	SnapshotWriter writer;
+	writer.writeInt(snapshot::MAGIC);
+	writer.writeInt(snapshot::VERSION);
+	writer.writeLongLong(eventLog.size());
+	writer.writeInt(tableCheckpoints.size());
+	for (auto& [number, state] : tableCheckpoints)
+	{
+		writer.writeBytes(state);
+	}
+	int sequence = checkpointSequence++;
+	executor->submit([this, sequence, data = writer.getData()]{ writeCheckpoint(sequence, data); });
 }
 
-void Server::sendTsarChoice_(int clientIndex)
+void Server::writeCheckpoint(int sequence, const std::vector<char>& data)
 {
-	std::unique_lock<std::mutex> receivedTsarStatementCardLock(receivedTsarStatementCardMutex);
-	receivedTsarStatementCardCvar.wait(receivedTsarStatementCardLock, [this]{ return receivedTsarStatementCard; });
-	receivedTsarStatementCardLock.unlock();
-
-	sendTsarStatementCardChoiceToClient(clientIndex);
-	userInterface.printMessage("Sent tsar choice to " + clients[clientIndex]->getUsername());
-	sentTsarStatementCardChoiceCounter++;
-	sentTsarStatementCardChoiceCvar.notify_all();
+	std::lock_guard<std::mutex> guard(checkpointMutex);
+	if (sequence < lastWrittenCheckpoint)
+	{
+		return;
+	}
+	lastWrittenCheckpoint = sequence;
+	// written next to the old one and renamed over it, so a crash mid-write keeps the previous round
+	std::string temporaryFilepath = checkpointFilepath + ".tmp";
+	std::ofstream checkpointFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+	checkpointFile.write(data.data(), data.size());
+	checkpointFile.close();
+	std::error_code error;
+	if (checkpointFile)
+	{
+		std::filesystem::rename(temporaryFilepath, checkpointFilepath, error);
+	}
+	if (!checkpointFile || error)
+	{
+		userInterface.printMessage("Failed to write checkpoint " + checkpointFilepath);
+	}
 }
 
-void Server::sendConfirmation_(int clientIndex)
+void Server::discardCheckpoint()
 {
-	std::unique_lock<std::mutex> receivedNextRoundConfirmationLock(receivedNextRoundConfirmationMutex);
-	receivedNextRoundConfirmationCvar.wait(receivedNextRoundConfirmationLock, [this]{ return receivedNextRoundConfirmationCounter == clients.size(); });
-	receivedNextRoundConfirmationLock.unlock();
-
-	sendServerConfirmationToClient(clientIndex);
-	sentServerConfirmationCounter++;
-	sentServerConfirmationCvar.notify_all();
-
-	std::unique_lock<std::mutex> resetFlagsLock(resetFlagsMutex);
-	resetFlagsCvar.wait(resetFlagsLock, [this]{ return resetFlags; });
-	resetFlagsLock.unlock();
+	// every table is done; any write still in flight sees a newer sequence and gives up
+	std::lock_guard<std::mutex> guard(checkpointMutex);
+	lastWrittenCheckpoint = std::numeric_limits<int>::max();
+	std::error_code error;
+	std::filesystem::remove(checkpointFilepath, error);
 }
 
-void Server::receiveData_(int clientIndex)
+void Server::restoreCheckpoint()
 {
-	std::unique_lock<std::mutex> dataSentLock(dataSentMutex);
-	dataSentCvar.wait(dataSentLock, [this]{ return dataSentCounter == clients.size(); });
-	dataSentLock.unlock();
-
-	int tsarIndex = game->getGameState().currentTsarIndex;
-
-	if (clientIndex != tsarIndex)
+	std::ifstream checkpointFile(checkpointFilepath, std::ios::binary);
+	if (!checkpointFile)
 	{
-		receiveStatementCardChoiceFromClient(clientIndex);
-		userInterface.printMessage("Received answer from " + clients[clientIndex]->getUsername());
-		receivedStatementCardChoicesCounter++;
-		receivedStatementCardChoicesCvar.notify_all();
+		return;
 	}
-	else
+	std::vector<char> data((std::istreambuf_iterator<char>(checkpointFile)), std::istreambuf_iterator<char>());
+	try
 	{
-		std::unique_lock<std::mutex> sentStatementCardChoicesLock(sentStatementCardChoicesMutex);
-		sentStatementCardChoicesCvar.wait(sentStatementCardChoicesLock, [this]{ return sentStatementCardChoicesCounter == clients.size(); });
-		sentStatementCardChoicesLock.unlock();
-
-		receiveStatementCardChoiceFromTsar(clientIndex);
-		userInterface.printMessage("Received answer from tsar. - " + clients[clientIndex]->getUsername());
-		receivedTsarStatementCard = true;
-		receivedTsarStatementCardCvar.notify_all();
+		SnapshotReader reader(data);
+		if (reader.readInt() != snapshot::MAGIC || reader.readInt() != snapshot::VERSION)
+		{
+			throw SnapshotException("Unsupported snapshot format.");
+		}
+		long long eventLogSize = reader.readLongLong();
+		int numOfTables = reader.readCount();
+		for (int i = 0; i < numOfTables; i++)
+		{
+			// the shards aren't running yet, their tables are set up from here
+			int shard = i % numOfShards;
+			std::vector<char> state = reader.readBytes();
+			Table& table = shards[shard]->restoreTable(state);
+			if (!tableCheckpoints.emplace(table.getNumber(), std::move(state)).second)
+			{
+				throw SnapshotException("Two tables saved under one number.");
+			}
+			for (auto& player : table.getPlayers())
+			{
+				if (!usernames.reserve(player->getUsername()))
+				{
+					throw SnapshotException("Player seated at two tables.");
+				}
+				sessions[player->getSessionToken()] = shard;
+			}
+			shardStatus[shard].numOfTables++;
+			numOfTablesDealt++;
+			newestTableShard = shard;
+			nextTableNumber = std::max(nextTableNumber, table.getNumber() + 1);
+		}
+		restoredEventLogSize = eventLogSize;
 	}
-}
-
-void Server::receiveConfirmation_(int clientIndex)
-{
-	std::unique_lock<std::mutex> sentTsarStatementCardChoiceLock(sentTsarStatementCardChoiceMutex);
-	sentTsarStatementCardChoiceCvar.wait(sentTsarStatementCardChoiceLock, [this]{ return sentTsarStatementCardChoiceCounter == clients.size(); });
-	sentTsarStatementCardChoiceLock.unlock();
-
-	receiveNextRoundConfirmationFromClient(clientIndex);
-	userInterface.printMessage("Received next round confirmation from " + clients[clientIndex]->getUsername());
-	receivedNextRoundConfirmationCounter++;
-	receivedNextRoundConfirmationCvar.notify_all();
-
-	std::unique_lock<std::mutex> resetFlagsLock(resetFlagsMutex);
-	resetFlagsCvar.wait(resetFlagsLock, [this]{ return resetFlags; });
-	resetFlagsLock.unlock();
-}
+	catch (SnapshotException& exception)
+	{
+		userInterface.printMessage("Ignoring checkpoint " + checkpointFilepath + ": " + exception.what());
+		for (int i = 0; i < numOfShards; i++)
+		{
+			shards[i]->discardRestoredTables();
+			shardStatus[i].numOfTables = 0;
+		}
+		tableCheckpoints.clear();
+		sessions.clear();
+		usernames.clear();
+		numOfTablesDealt = 0;
+		nextTableNumber = 1;
+		newestTableShard = -1;
+	}
+}
\ No newline at end of file
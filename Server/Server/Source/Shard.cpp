@@ -0,0 +1,410 @@
+#include "Shard.h"
+#include "Interface.h"
+
+#include <algorithm>
+#include <random>
+
+Shard::Shard(int index, int numOfShards, EventLoop& serverLoop, Doorbell& serverDoorbell, Executor& executor, Interface& userInterface,
+	std::shared_ptr<DeckLibrary> decks, const TableSettings& tableSettings, int minNumOfPlayers, std::chrono::milliseconds lobbyTimeout) :
+	index{ index },
+	numOfShards{ numOfShards },
+	executor{ executor },
+	userInterface{ userInterface },
+	decks{ std::move(decks) },
+	tableSettings{ tableSettings },
+	lobbyTimeout{ lobbyTimeout },
+	nextTableNumber{ 1 },
+	tableQuota{ 0 },
+	numOfTablesDealt{ 0 },
+	running{ false },
+	doorbell{ loop },
+	commands(serverLoop, doorbell, shard::MAILBOX_CAPACITY),
+	reports(loop, serverDoorbell, shard::MAILBOX_CAPACITY),
+	lobby(loop, tableSettings.configuration.numOfPlayers, minNumOfPlayers, lobbyTimeout)
+{
+	lobby.onTableFormed = [this](Lobby::Players players){ openTable(std::move(players)); };
+	lobby.onExpired = [this](Lobby::Players players)
+	{
+		this->userInterface.printMessage("Lobby expired before enough players joined, sending " + std::to_string(players.size()) + " home.");
+		sendHome(players, ShardReportType::LobbyExpired);
+	};
+}
+
+Table& Shard::restoreTable(const std::vector<char>& state)
+{
+	Table& table = addTable(SnapshotReader(state).readInt());
+	table.restoreState(state);
+	for (auto& player : table.getPlayers())
+	{
+		sessions[player->getSessionToken()] = &table;
+	}
+	return table;
+}
+
+void Shard::discardRestoredTables()
+{
+	tables.clear();
+	sessions.clear();
+}
+
+void Shard::start(int firstTableNumber, int tableQuota)
+{
+	nextTableNumber = firstTableNumber + index;
+	this->tableQuota = tableQuota;
+	running = true;
+	// whatever was set up so far is handed to the thread with it
+	thread = std::thread([this]{ run(); });
+}
+
+void Shard::join()
+{
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+void Shard::run()
+{
+	// the restored players reconnect with their session tokens, whoever isn't back in time sits out
+	for (auto& table : tables)
+	{
+		table->awaitPlayers(lobbyTimeout);
+	}
+	if (tableQuota != 0)
+	{
+		lobby.open();
+	}
+	loop.spawn(receiveCommands());
+	loop.run();
+}
+
+Task Shard::receiveCommands()
+{
+	ShardCommand command;
+	while (running)
+	{
+		while (running && commands.receive(command))
+		{
+			switch (command.type)
+			{
+				case ShardCommandType::Join: loop.spawn(joinLobby(std::move(command.client))); break;
+				case ShardCommandType::Resume: loop.spawn(resumeSession(std::move(command.client))); break;
+				case ShardCommandType::Spectate: loop.spawn(watchTable(std::move(command.client))); break;
+				case ShardCommandType::CloseLobby: closeLobby(); break;
+				case ShardCommandType::Stop: stop(); break;
+			}
+		}
+		if (running)
+		{
+			co_await doorbell.wait();
+		}
+	}
+}
+
+bool Shard::connect(Client& client)
+{
+	try
+	{
+		client.setConnection(std::make_unique<AsyncSocket>(loop, client.getSocket().GetHandle()));
+		return true;
+	}
+	catch (ConnectionException& exception)
+	{
+		userInterface.printMessage(exception.what());
+		return false;
+	}
+}
+
+Task Shard::joinLobby(std::unique_ptr<Client> client)
+{
+	if (!connect(*client))
+	{
+		report(ShardReportType::Left, 0, { client->getUsername() });
+		co_return;
+	}
+	AsyncSocket& connection = client->getConnection();
+	// the server placed the player while the lobby was open, it may have closed since
+	bool accepted = lobby.isOpen();
+	SessionToken sessionToken = client->getSessionToken();
+	std::shared_ptr<Client> player;
+	if (accepted)
+	{
+		userInterface.printMessage(client->getUsername() + " joined!");
+		player = std::move(client);
+	}
+	else
+	{
+		report(ShardReportType::Left, 0, { client->getUsername() });
+	}
+	try
+	{
+		co_await connection.send(&accepted, sizeof(bool));
+		if (accepted)
+		{
+			co_await connection.send(&sessionToken, sizeof(SessionToken));
+		}
+	}
+	catch (ConnectionException& exception)
+	{
+		userInterface.printMessage("Handshake failed: " + std::string(exception.what()));
+		if (player)
+		{
+			sendHome({ player });
+		}
+		co_return;
+	}
+	if (!accepted)
+	{
+		// a refused peer still gets its answer
+		connection.closeAfterSending();
+		co_return;
+	}
+	// watches the player while it waits, so leaving the lobby frees its place for somebody else
+	loop.spawn(readMessages(player));
+	if (lobby.isOpen())
+	{
+		lobby.join(player);
+	}
+	else
+	{
+		sendHome({ player });
+	}
+}
+
+Task Shard::resumeSession(std::unique_ptr<Client> client)
+{
+	if (!connect(*client))
+	{
+		co_return;
+	}
+	std::unique_ptr<AsyncSocket> connection = client->releaseConnection();
+	AsyncSocket& reply = *connection;
+	// the game may have ended since the server looked the session up
+	auto session = sessions.find(client->getSessionToken());
+	bool accepted = session != sessions.end();
+	if (accepted)
+	{
+		loop.spawn(readMessages(session->second->resume(client->getSessionToken(), std::move(connection))));
+	}
+	try
+	{
+		co_await reply.send(&accepted, sizeof(bool));
+	}
+	catch (ConnectionException& exception)
+	{
+		// an accepted player is dropped by its own reader
+		userInterface.printMessage("Handshake failed: " + std::string(exception.what()));
+	}
+	if (!accepted)
+	{
+		reply.closeAfterSending();
+	}
+}
+
+Task Shard::watchTable(std::unique_ptr<Client> client)
+{
+	if (!connect(*client))
+	{
+		co_return;
+	}
+	AsyncSocket& connection = client->getConnection();
+	bool accepted = running;
+	try
+	{
+		co_await connection.send(&accepted, sizeof(bool));
+	}
+	catch (ConnectionException& exception)
+	{
+		userInterface.printMessage("Handshake failed: " + std::string(exception.what()));
+		co_return;
+	}
+	if (!accepted)
+	{
+		connection.closeAfterSending();
+	}
+	// the newest table is the one most of its game is left to watch
+	else if (!tables.empty())
+	{
+		tables.back()->addSpectator(client->releaseConnection());
+	}
+	else
+	{
+		waitingSpectators.emplace_back(client->releaseConnection());
+	}
+}
+
+Task Shard::readMessages(std::shared_ptr<Client> client)
+{
+	AsyncSocket& connection = client->getConnection();
+	// a reader woken by the close of a replaced connection must not drop its successor
+	auto current = [&client, &connection]{ return &client->getConnection() == &connection; };
+	// clients heartbeat while idle, so silence this long means the connection is dead
+	Timer idleDeadline;
+	idleDeadline.callback = [this, &client, current]
+	{
+		if (current())
+		{
+			dropClient(*client, "idle for too long");
+		}
+	};
+	try
+	{
+		while (true)
+		{
+			// a player waiting in the lobby has nothing to say until its table is dealt
+			std::chrono::milliseconds idleTimeout(protocol::IDLE_TIMEOUT_MILLISECONDS);
+			std::chrono::milliseconds waitingTimeout = lobbyTimeout + std::chrono::milliseconds(lobby::FILL_TIMEOUT_MILLISECONDS);
+			loop.timers().schedule(idleDeadline, lobby.contains(*client) ? waitingTimeout + idleTimeout : idleTimeout);
+			MessageHeader header;
+			co_await connection.receive(&header, sizeof(MessageHeader));
+			if (header.length < 0 || header.length > protocol::MAX_MESSAGE_LENGTH)
+			{
+				throw ConnectionException("Malformed message header.");
+			}
+			Message message;
+			message.type = static_cast<MessageType>(header.type);
+			message.round = header.round;
+			message.payload = client->getInbox().takeBuffer();
+			message.payload.resize(header.length);
+			if (header.length > 0)
+			{
+				co_await connection.receive(message.payload.data(), header.length);
+			}
+			if (message.type != MessageType::Heartbeat)
+			{
+				client->getInbox().push(std::move(message));
+			}
+			else
+			{
+				client->getInbox().recycle(std::move(message));
+			}
+		}
+	}
+	catch (ConnectionException& exception)
+	{
+		if (current())
+		{
+			dropClient(*client, exception.what());
+		}
+	}
+	// nothing but its reader watches a waiting player, so the reader is the one to give up its place
+	if (current() && !client->isConnected() && lobby.leave(*client))
+	{
+		idleDeadline.cancel();
+		userInterface.printMessage(client->getUsername() + " left the lobby.");
+		report(ShardReportType::Left, 0, { client->getUsername() });
+	}
+}
+
+void Shard::dropClient(Client& client, const std::string& reason)
+{
+	if (client.isConnected() || client.isResuming())
+	{
+		userInterface.printMessage(client.getUsername() + " disconnected: " + reason);
+		client.disconnect();
+	}
+}
+
+void Shard::sendHome(const Lobby::Players& players, ShardReportType type)
+{
+	if (players.empty())
+	{
+		return;
+	}
+	std::vector<std::string> usernames;
+	for (auto& player : players)
+	{
+		usernames.emplace_back(player->getUsername());
+		player->disconnect();
+	}
+	report(type, 0, std::move(usernames));
+}
+
+void Shard::closeLobby()
+{
+	if (!lobby.isOpen())
+	{
+		return;
+	}
+	sendHome(lobby.close());
+	report(ShardReportType::LobbyClosed);
+}
+
+void Shard::stop()
+{
+	// lets the message readers and the tables' coroutines finish so the loop can run out of tasks
+	running = false;
+	closeLobby();
+	for (auto& connection : waitingSpectators)
+	{
+		connection->closeAfterSending();
+	}
+}
+
+void Shard::openTable(Lobby::Players players)
+{
+	Table& table = addTable(nextTableNumber);
+	nextTableNumber += numOfShards;
+	numOfTablesDealt++;
+	if (players.size() < tableSettings.configuration.numOfPlayers)
+	{
+		userInterface.printMessage("Lobby expired, table #" + std::to_string(table.getNumber()) + " starts with " + std::to_string(players.size()) + " players.");
+	}
+	table.seat(std::move(players), std::random_device()());
+	std::vector<SessionToken> sessionTokens;
+	for (auto& player : table.getPlayers())
+	{
+		sessions[player->getSessionToken()] = &table;
+		sessionTokens.emplace_back(player->getSessionToken());
+	}
+	report(ShardReportType::TableDealt, table.getNumber(), {}, std::move(sessionTokens));
+	for (auto& connection : waitingSpectators)
+	{
+		table.addSpectator(std::move(connection));
+	}
+	waitingSpectators.clear();
+	table.start();
+	if (tableQuota > 0 && numOfTablesDealt == tableQuota)
+	{
+		closeLobby();
+	}
+}
+
+Table& Shard::addTable(int number)
+{
+	// the table keeps the current version of the decks even if they are reloaded while it plays
+	tables.emplace_back(std::make_unique<Table>(loop, executor, userInterface, number, tableSettings, decks->current()));
+	Table& table = *tables.back();
+	table.onRoundEnded = [this](Table& table){ report(ShardReportType::RoundEnded, table.getNumber(), {}, {}, table.getCheckpoint(), table.getEventRecords()); };
+	table.onGameEnded = [this](Table& table){ endGame(table); };
+	table.onIdle = [this](Table& table){ removeTable(table); };
+	return table;
+}
+
+void Shard::endGame(Table& table)
+{
+	std::vector<std::string> usernames;
+	std::vector<SessionToken> sessionTokens;
+	for (auto& player : table.getPlayers())
+	{
+		sessions.erase(player->getSessionToken());
+		usernames.emplace_back(player->getUsername());
+		sessionTokens.emplace_back(player->getSessionToken());
+	}
+	report(ShardReportType::GameEnded, table.getNumber(), std::move(usernames), std::move(sessionTokens), {}, table.getEventRecords());
+	auto entry = std::find_if(tables.begin(), tables.end(), [&table](auto& other){ return other.get() == &table; });
+	endedTables.splice(endedTables.end(), tables, entry);
+}
+
+void Shard::removeTable(Table& table)
+{
+	auto entry = std::find_if(endedTables.begin(), endedTables.end(), [&table](auto& other){ return other.get() == &table; });
+	endedTables.erase(entry);
+}
+
+void Shard::report(ShardReportType type, int table, std::vector<std::string> usernames, std::vector<SessionToken> sessionTokens,
+	std::vector<char> data, std::vector<char> records)
+{
+	reports.send(ShardReport{ type, index, table, std::move(usernames), std::move(sessionTokens), std::move(data), std::move(records) });
+}
\ No newline at end of file
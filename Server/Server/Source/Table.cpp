@@ -0,0 +1,870 @@
+#include "Table.h"
+#include "Interface.h"
+#include "GameDataManager.h"
+#include "SeededGenerator.h"
+#include "GeneratorStrategy.h"
+
+#include <algorithm>
+#include <cstring>
+
+Table::Table(EventLoop& loop, Executor& executor, Interface& userInterface, int number, const TableSettings& settings, std::shared_ptr<const Deck> deck) :
+	loop{ loop },
+	executor{ executor },
+	userInterface{ userInterface },
+	number{ number },
+	label{ "Table #" + std::to_string(number) + ": " },
+	configuration{ settings.configuration },
+	phaseTimeout{ settings.phaseTimeout },
+	timeoutPolicy{ settings.timeoutPolicy },
+	quiet{ settings.quiet },
+	deck{ std::move(deck) },
+	seed{ 0 },
+	started{ false },
+	finished{ false },
+	firstRound{ 0 },
+	currentRound{ 0 },
+	activeTasks{ 0 },
+	tsarChoiceIndex{ protocol::NO_WINNER },
+	roundWinnerIndex{ protocol::NO_WINNER },
+	roundDataGenerated{ loop },
+	receivedStatementCardChoices{ loop },
+	shuffledStatementCards{ loop },
+	receivedTsarStatementCard{ loop },
+	receivedNextRoundConfirmation{ loop },
+	roundEnd{ loop }
+{
+
+}
+
+void Table::seat(Players players, unsigned int seed)
+{
+	// a table formed when the lobby expired has fewer seats than configured
+	configuration.numOfPlayers = players.size();
+	clients = std::move(players);
+	this->seed = seed;
+	createGame();
+}
+
+void Table::restoreState(const std::vector<char>& state)
+{
+	SnapshotReader reader(state);
+	if (reader.readInt() != number)
+	{
+		throw SnapshotException("Table saved under another number.");
+	}
+	firstRound = reader.readInt();
+	// the shuffles are seeded from it and the event log recorded it, the restored game needs the same one
+	seed = reader.readInt();
+	int numOfPlayers = reader.readCount();
+	if (numOfPlayers < 2 || numOfPlayers > configuration.numOfPlayers || firstRound < 0 || firstRound >= configuration.numOfRounds)
+	{
+		throw SnapshotException("Snapshot was taken with a different game configuration.");
+	}
+	configuration.numOfPlayers = numOfPlayers;
+	for (int i = 0; i < numOfPlayers; i++)
+	{
+		std::shared_ptr<Client> client(std::make_shared<Client>());
+		client->setUsername(reader.readString());
+		client->setScore(reader.readInt());
+		client->setSessionToken(reader.readLongLong());
+		client->setDisconnected();
+		clients.emplace_back(std::move(client));
+	}
+	createGame();
+	game->restoreState(reader);
+	// saved again as it is until the table gets through another round
+	checkpoint = state;
+}
+
+void Table::start()
+{
+	started = true;
+	resumeDeadline.cancel();
+	// a restored game was already logged up to its checkpoint
+	if (firstRound == 0)
+	{
+		logGameStarted();
+	}
+	// the buffer holds a round's events at a time, the last round's with the end of the game
+	records.reserve(records.size() + getMaxRecordBytesPerRound() + getMaxRecordBytes(clients.size()));
+	printMessage("All players connected. Starting game.");
+	int numOfClients = clients.size();
+	submissions.resize(numOfClients);
+	receivedStatementCardChoices.setExpected(numOfClients - 1); // tsar doesn't choose
+	receivedNextRoundConfirmation.setExpected(numOfClients);
+	// every player session and the game logic finish a round together
+	roundEnd.setParticipants(numOfClients + 1);
+	roundEnd.setCompletion([this]{ resetData(); });
+	loop.spawn(tracked(gameLogic()));
+	// every connected player already has a reader, started when it joined the lobby or resumed
+	for (int i = 0; i < numOfClients; i++)
+	{
+		loop.spawn(tracked(playerSession(i)));
+	}
+}
+
+void Table::awaitPlayers(std::chrono::milliseconds timeout)
+{
+	printMessage("Restored at round #" + std::to_string(firstRound + 1) + ", waiting for players to resume.");
+	// whoever isn't back in time sits out until it resumes
+	resumeDeadline.callback = [this]{ start(); };
+	loop.timers().schedule(resumeDeadline, timeout);
+}
+
+std::shared_ptr<Client> Table::resume(SessionToken sessionToken, std::unique_ptr<AsyncSocket> connection)
+{
+	auto player = std::find_if(clients.begin(), clients.end(), [sessionToken](auto& player){ return player->getSessionToken() == sessionToken; });
+	// the old connection may not have noticed it is dead yet
+	std::shared_ptr<Client> resumed = *player;
+	dropClient(*resumed, "resumed on a new connection");
+	resumed->setConnection(std::move(connection));
+	resumed->setResuming();
+	printMessage(resumed->getUsername() + " reconnected, rejoining next round.");
+	if (!started && allPlayersPresent())
+	{
+		start();
+	}
+	return resumed;
+}
+
+void Table::addSpectator(std::unique_ptr<AsyncSocket> connection)
+{
+	spectators.emplace_back(std::make_unique<Spectator>(std::move(connection)));
+	// a spectator joining mid-game starts from the table as it was last shown
+	if (latestFrame)
+	{
+		spectators.back()->push(latestFrame);
+	}
+	loop.spawn(tracked(spectatorSession(*spectators.back())));
+}
+
+void Table::createGame()
+{
+	std::unique_ptr<GeneratorStrategy> strategy = std::unique_ptr<SeededGenerator>(new SeededGenerator(seed));
+	std::unique_ptr<GameDataManager> manager = std::unique_ptr<GameDataManager>(new GameDataManager(std::move(strategy)));
+
+	game = std::unique_ptr<Game>(new Game(deck->getPrompts(), deck->getStatementCards(),
+										  std::move(manager), configuration));
+}
+
+bool Table::allPlayersPresent() const
+{
+	return std::none_of(clients.begin(), clients.end(), [](auto& client){ return !client->isConnected() && !client->isResuming(); });
+}
+
+Task Table::tracked(Task task)
+{
+	activeTasks++;
+	co_await task;
+	// the server may destroy the table from here, nothing of it is touched afterwards
+	if (--activeTasks == 0 && finished)
+	{
+		onIdle(*this);
+	}
+}
+
+void Table::printMessage(const std::string& message)
+{
+	if (quiet)
+	{
+		return;
+	}
+	userInterface.printMessage({ label, message });
+}
+
+void Table::printMessage(std::initializer_list<std::string_view> parts)
+{
+	if (quiet)
+	{
+		return;
+	}
+	std::string message(label);
+	for (std::string_view part : parts)
+	{
+		message += part;
+	}
+	userInterface.printMessage(message);
+}
+
+void Table::saveState(int nextRound)
+{
+	// serialized here, between rounds, so the state can't change under the writer
+	checkpointWriter.clear();
+	checkpointWriter.writeInt(number);
+	checkpointWriter.writeInt(nextRound);
+	checkpointWriter.writeInt(seed);
+	checkpointWriter.writeInt(clients.size());
+	for (auto& client : clients)
+	{
+		checkpointWriter.writeString(client->getUsername());
+		checkpointWriter.writeInt(client->getScore());
+		checkpointWriter.writeLongLong(client->getSessionToken());
+	}
+	game->saveState(checkpointWriter);
+	// from the first checkpoint on, both buffers have room for the game's last one: its drawn cards
+	// grow by a bounded amount each round, the hands' texts get as much room again as they take now
+	if (nextRound == firstRound + 1)
+	{
+		std::size_t capacity = 2 * checkpointWriter.getData().size() + (configuration.numOfRounds - nextRound) * getMaxCheckpointBytesPerRound();
+		checkpointWriter.reserve(capacity);
+		checkpoint.reserve(capacity);
+	}
+	// the previous checkpoint's buffer is the one written next, neither is copied
+	checkpointWriter.swapData(checkpoint);
+}
+
+Task Table::spectatorSession(Spectator& spectator)
+{
+	AsyncSocket& connection = spectator.getConnection();
+	try
+	{
+		while (SpectatorFrame frame = co_await spectator.next())
+		{
+			co_await connection.send(frame->data(), frame->size());
+		}
+	}
+	catch (ConnectionException&)
+	{
+		// a spectator leaving is nothing the game has to know about
+	}
+	connection.closeAfterSending();
+	auto self = std::find_if(spectators.begin(), spectators.end(), [&spectator](auto& other){ return other.get() == &spectator; });
+	std::swap(*self, spectators.back());
+	spectators.pop_back();
+}
+
+void Table::publishToSpectators(TableStage stage)
+{
+	// encoded once, every spectator's queue only takes a reference to it
+	frameWriter.clear();
+	frameWriter.writeInt(static_cast<int>(stage));
+	frameWriter.writeInt(currentRound);
+	frameWriter.writeInt(configuration.numOfRounds);
+	frameWriter.writeInt(clients.size());
+	for (auto& client : clients)
+	{
+		frameWriter.writeString(client->getUsername());
+		frameWriter.writeInt(client->getScore());
+	}
+	const GameState& state = game->getGameState();
+	frameWriter.writeInt(state.currentTsarIndex);
+	frameWriter.writeString(state.currentPrompt.text);
+	int numOfChoices = stage == TableStage::Dealt ? 0 : submissions.size();
+	frameWriter.writeInt(numOfChoices);
+	for (int position = 0; position < numOfChoices; position++)
+	{
+		const Submission& submission = submissions.getSubmissionAt(position);
+		frameWriter.writeInt(submission.numOfCards);
+		for (int i = 0; i < submission.numOfCards; i++)
+		{
+			frameWriter.writeString(game->getStatementCardText(submission.cardIds[i]));
+		}
+	}
+	frameWriter.writeInt(stage == TableStage::Judged ? tsarChoiceIndex : protocol::NO_WINNER);
+	frameWriter.writeInt(stage == TableStage::Judged ? roundWinnerIndex : protocol::NO_WINNER);
+
+	if (!latestFrame || latestFrame.use_count() > 1)
+	{
+		latestFrame = std::make_shared<std::vector<char>>();
+	}
+	const std::vector<char>& data = frameWriter.getData();
+	int length = data.size();
+	latestFrame->resize(sizeof(int) + length);
+	std::memcpy(latestFrame->data(), &length, sizeof(int));
+	std::memcpy(latestFrame->data() + sizeof(int), data.data(), length);
+	for (auto& spectator : spectators)
+	{
+		spectator->push(latestFrame);
+	}
+}
+
+void Table::finishSpectators()
+{
+	for (auto& spectator : spectators)
+	{
+		spectator->finish();
+	}
+	// whoever is still behind after the grace period is cut off
+	spectatorDeadline.callback = [this]
+	{
+		for (auto& spectator : spectators)
+		{
+			spectator->getConnection().close();
+		}
+	};
+	loop.timers().schedule(spectatorDeadline, std::chrono::milliseconds(spectator::DRAIN_TIMEOUT_MILLISECONDS));
+}
+
+Task Table::gameLogic()
+{
+	for (int i = firstRound; i < game->getGameConfiguration().numOfRounds; i++)
+	{
+		currentRound = i;
+		try
+		{
+			co_await generateData_();
+		}
+		catch (DeckException& exception)
+		{
+			// the game ends with the last full round; the sessions waiting for this one's cards are let go
+			printMessage(std::string(exception.what()) + " Ending the game after " + std::to_string(i) + " rounds.");
+			game->setNumOfRounds(i);
+			roundDataGenerated.countDown();
+			break;
+		}
+		publishToSpectators(TableStage::Dealt);
+		co_await receivedStatementCardChoices;
+		shuffleStatementCards_();
+		publishToSpectators(TableStage::ChoicesRevealed);
+		co_await receivedTsarStatementCard;
+		publishToSpectators(TableStage::Judged);
+		co_await roundEnd.arriveAndWait();
+		if (i + 1 < game->getGameConfiguration().numOfRounds)
+		{
+			saveState(i + 1);
+			onRoundEnded(*this);
+			records.clear();
+		}
+	}
+	logGameEnded();
+	finished = true;
+	printSendQueueMetrics();
+	auto winner = std::max_element(clients.begin(), clients.end(), [](auto& client1, auto& client2){ return client1->getScore() < client2->getScore(); });
+	printMessage(winner->get()->getUsername() + " won.");
+	for (auto& client : clients)
+	{
+		// the last confirmation may still be queued
+		client->disconnect(true);
+	}
+	finishSpectators();
+	onGameEnded(*this);
+}
+
+Task Table::playerSession(int clientIndex)
+{
+	co_await guarded(clientIndex, sendPlayerIDToClient(clientIndex));
+	co_await guarded(clientIndex, sendPlayerListToClient(clientIndex));
+	co_await guarded(clientIndex, sendNumOfRoundsToClient(clientIndex));
+	co_await guarded(clientIndex, sendNumOfStatementCardsToClient(clientIndex));
+	// a dropped player keeps going through the phases without I/O so nobody waits on it
+	for (int i = firstRound; i < game->getGameConfiguration().numOfRounds; i++)
+	{
+		co_await sendData_(clientIndex, i);
+		// the deck ran out before this round could be dealt
+		if (i >= game->getGameConfiguration().numOfRounds)
+		{
+			break;
+		}
+		co_await receiveData_(clientIndex, i);
+		co_await sendStatementCardChoices_(clientIndex);
+		co_await receiveTsarChoice_(clientIndex, i);
+		co_await sendTsarChoice_(clientIndex);
+		co_await receiveConfirmation_(clientIndex, i);
+		co_await sendConfirmation_(clientIndex);
+		co_await roundEnd.arriveAndWait();
+	}
+}
+
+Task Table::receiveMessage(int clientIndex, MessageType type, int round, std::optional<Message>& message)
+{
+	// a player sitting the round out was never sent this phase, so there is nothing to wait for
+	if (clients[clientIndex]->isConnected())
+	{
+		message = co_await clients[clientIndex]->getInbox().receive(type, round, phaseTimeout);
+	}
+}
+
+Task Table::guarded(int clientIndex, Task operation)
+{
+	if (!clients[clientIndex]->isConnected())
+	{
+		co_return;
+	}
+	try
+	{
+		co_await operation;
+	}
+	catch (ConnectionException& exception)
+	{
+		dropClient(*clients[clientIndex], exception.what());
+	}
+}
+
+bool Table::handleMissedDeadline(int clientIndex)
+{
+	if (clients[clientIndex]->isConnected())
+	{
+		printMessage({ clients[clientIndex]->getUsername(), " missed the deadline." });
+		if (timeoutPolicy == TimeoutPolicy::DropConnection)
+		{
+			dropClient(*clients[clientIndex], "timed out");
+		}
+	}
+	return timeoutPolicy == TimeoutPolicy::AutoPlay;
+}
+
+void Table::dropClient(Client& client, const std::string& reason)
+{
+	if (client.isConnected() || client.isResuming())
+	{
+		printMessage(client.getUsername() + " disconnected: " + reason);
+		client.disconnect();
+	}
+}
+
+void Table::printSendQueueMetrics()
+{
+	for (auto& client : clients)
+	{
+		if (client->hasConnection())
+		{
+			const SendQueue& sendQueue = client->getConnection().getSendQueue();
+			printMessage({ client->getUsername(), "'s send queue peaked at ", std::to_string(sendQueue.getPeakQueuedBytes()),
+				" bytes, over the high watermark ", std::to_string(sendQueue.getNumOfStalls()), " times." });
+		}
+	}
+}
+
+void Table::receiveStatementCardChoiceFromClient(int clientIndex, const Message& message)
+{
+	MessageReader reader(message);
+	const std::vector<int>& cardIds = game->getStatementCardIdsOfPlayer(clientIndex);
+	int numOfBlanks = game->getGameState().currentPrompt.numOfBlanks;
+	Submission& submission = submissions.row(clientIndex);
+	for (int i = 0; i < numOfBlanks; i++)
+	{
+		// cards are chosen by ID, which has to be one the server dealt to this player
+		int cardId = reader.readInt();
+		int choiceIndex = std::find(cardIds.begin(), cardIds.end(), cardId) - cardIds.begin();
+		if (choiceIndex == cardIds.size())
+		{
+			throw ConnectionException("Statement card not in hand.");
+		}
+		if (std::find(submission.handIndices, submission.handIndices + i, choiceIndex) != submission.handIndices + i)
+		{
+			throw ConnectionException("Statement card chosen twice.");
+		}
+		submission.handIndices[i] = choiceIndex;
+		submission.cardIds[i] = cardIds[choiceIndex];
+	}
+	submission.numOfCards = numOfBlanks;
+	for (int i = 0; i < submission.numOfCards; i++)
+	{
+		game->setPlayerStatementCardAsUsed(clientIndex, submission.handIndices[i]);
+	}
+	logCardsSubmitted(clientIndex, submission, false);
+	submission.submitted = true;
+}
+
+void Table::receiveStatementCardChoiceFromTsar(const Message& message)
+{
+	MessageReader reader(message);
+	int choiceIndex = reader.readInt();
+	if (choiceIndex < 0 || choiceIndex >= submissions.size())
+	{
+		throw ConnectionException("Tsar choice out of range.");
+	}
+	setRoundWinner(choiceIndex);
+}
+
+void Table::autoPlayStatementCardChoice(int clientIndex)
+{
+	const std::vector<int>& cardIds = game->getStatementCardIdsOfPlayer(clientIndex);
+	int numOfBlanks = game->getGameState().currentPrompt.numOfBlanks;
+	std::pmr::vector<int> handIndices(cardIds.size(), roundArena.resource());
+	for (int i = 0; i < handIndices.size(); i++)
+	{
+		handIndices[i] = i;
+	}
+	Submission& submission = submissions.row(clientIndex);
+	submission.numOfCards = 0;
+	for (int i = 0; i < numOfBlanks && i < handIndices.size(); i++)
+	{
+		std::swap(handIndices[i], handIndices[i + roundRandom.nextBelow(handIndices.size() - i)]);
+		game->setPlayerStatementCardAsUsed(clientIndex, handIndices[i]);
+		submission.handIndices[i] = handIndices[i];
+		submission.cardIds[i] = cardIds[handIndices[i]];
+		submission.numOfCards++;
+	}
+	logCardsSubmitted(clientIndex, submission, true);
+	submission.submitted = true;
+}
+
+void Table::autoPlayTsarChoice()
+{
+	setRoundWinner(roundRandom.nextBelow(submissions.size()));
+}
+
+void Table::setRoundWinner(int choiceIndex)
+{
+	// the tsar picks a position in the shuffled order, which leads back to the player
+	tsarChoiceIndex = choiceIndex;
+	roundWinnerIndex = submissions.getPlayerAt(choiceIndex);
+	clients[roundWinnerIndex]->incrementScore();
+	logWinnerChosen();
+}
+
+Task Table::sendPlayerIDToClient(int clientIndex)
+{
+	co_await clients[clientIndex]->getConnection().send(&clientIndex, sizeof(int));
+}
+
+Task Table::sendPlayerListToClient(int clientIndex)
+{
+	GatherWriter message;
+	message.writeInt(clients.size());
+	for (auto& client : clients)
+	{
+		message.writeString(client->getUsername());
+	}
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+Task Table::sendNumOfRoundsToClient(int clientIndex)
+{
+	int numOfRounds = game->getGameConfiguration().numOfRounds;
+	co_await clients[clientIndex]->getConnection().send(&numOfRounds, sizeof(int));
+}
+
+Task Table::sendNumOfStatementCardsToClient(int clientIndex)
+{
+	int numOfStatementCards = game->getGameConfiguration().numOfStatementCards;
+	co_await clients[clientIndex]->getConnection().send(&numOfStatementCards, sizeof(int));
+}
+
+Task Table::sendGeneratedTsarIndexToClient(int clientIndex)
+{
+	co_await clients[clientIndex]->getConnection().send(&(game->getGameState().currentTsarIndex), sizeof(int));
+}
+
+Task Table::sendGeneratedPromptToClient(int clientIndex)
+{
+	const Prompt& prompt = game->getGameState().currentPrompt;
+	GatherWriter message;
+	message.writeString(prompt.text);
+	message.writeInt(prompt.numOfBlanks);
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+Task Table::sendGeneratedStatementCardsToClient(int clientIndex)
+{
+	const std::vector<StatementText>& statementCards = game->getGameState().statementCards[clientIndex];
+	const std::vector<int>& cardIds = game->getStatementCardIdsOfPlayer(clientIndex);
+	// card texts are sent from the deck's memory
+	GatherWriter message;
+	message.writeInt(statementCards.size());
+	for (int i = 0; i < statementCards.size(); i++)
+	{
+		message.writeInt(cardIds[i]);
+		message.writeString(statementCards[i]);
+	}
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+Task Table::sendStatementCardChoicesToClient(int clientIndex)
+{
+	int numOfChoices = submissions.size(); // tsar and skipped players don't choose
+	GatherWriter message;
+	message.writeInt(numOfChoices);
+	for (int position = 0; position < numOfChoices; position++)
+	{
+		const Submission& submission = submissions.getSubmissionAt(position);
+		// autoplay may have played fewer cards than the prompt has blanks
+		message.writeInt(submission.numOfCards);
+		for (int i = 0; i < submission.numOfCards; i++)
+		{
+			message.writeString(game->getStatementCardText(submission.cardIds[i]));
+		}
+	}
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+Task Table::sendTsarStatementCardChoiceToClient(int clientIndex)
+{
+	GatherWriter message;
+	message.writeInt(roundWinnerIndex);
+	message.writeInt(tsarChoiceIndex);
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+Task Table::sendServerConfirmationToClient(int clientIndex)
+{
+	bool confirmation;
+	co_await clients[clientIndex]->getConnection().send(&confirmation, sizeof(bool));
+}
+
+Task Table::sendSnapshotToClient(int clientIndex, int round)
+{
+	GatherWriter message;
+	message.writeInt(round);
+	message.writeInt(clients.size());
+	for (auto& client : clients)
+	{
+		message.writeInt(client->getScore());
+	}
+	const std::vector<StatementText>& hand = game->getStatementCardsOfPlayer(clientIndex);
+	const std::vector<int>& cardIds = game->getStatementCardIdsOfPlayer(clientIndex);
+	message.writeInt(hand.size());
+	for (int i = 0; i < hand.size(); i++)
+	{
+		message.writeInt(cardIds[i]);
+		message.writeString(hand[i]);
+	}
+	co_await clients[clientIndex]->getConnection().send(message);
+}
+
+void Table::resetData()
+{
+	roundDataGenerated.reset();
+	receivedStatementCardChoices.reset();
+	shuffledStatementCards.reset();
+	receivedTsarStatementCard.reset();
+	receivedNextRoundConfirmation.reset();
+	submissions.clear();
+	roundArena.reset();
+	tsarChoiceIndex = protocol::NO_WINNER;
+	roundWinnerIndex = protocol::NO_WINNER;
+}
+
+Task Table::generateData_()
+{
+	// deck sampling runs on the executor so the event loop keeps serving sockets meanwhile
+	co_await executor.offload(loop, [this]{ game->generateRoundData(); });
+	roundRandom.seed(seed, currentRound);
+	logRoundDealt();
+	int tsarIndex = game->getGameState().currentTsarIndex;
+	printMessage("Tsar Index: " + std::to_string(tsarIndex));
+	roundDataGenerated.countDown();
+}
+
+void Table::shuffleStatementCards_()
+{
+	// fixed once per round, every sender presents the same order and the tsar can't tell who is who
+	submissions.shuffle(roundRandom);
+	shuffledStatementCards.countDown();
+}
+
+Task Table::sendData_(int clientIndex, int round)
+{
+	co_await roundDataGenerated;
+	if (round >= game->getGameConfiguration().numOfRounds)
+	{
+		co_return;
+	}
+
+	// a resumed player picks the game back up here, with a snapshot of what it missed
+	if (clients[clientIndex]->isResuming())
+	{
+		clients[clientIndex]->setConnected();
+		co_await guarded(clientIndex, sendSnapshotToClient(clientIndex, round));
+	}
+
+	int tsarIndex = game->getGameState().currentTsarIndex;
+	printMessage({ "Sending data to ", clients[clientIndex]->getUsername() });
+	co_await guarded(clientIndex, sendGeneratedTsarIndexToClient(clientIndex));
+	co_await guarded(clientIndex, sendGeneratedPromptToClient(clientIndex));
+	if (clientIndex != tsarIndex)
+	{
+		co_await guarded(clientIndex, sendGeneratedStatementCardsToClient(clientIndex));
+	}
+}
+
+Task Table::sendStatementCardChoices_(int clientIndex)
+{
+	co_await shuffledStatementCards;
+
+	co_await guarded(clientIndex, sendStatementCardChoicesToClient(clientIndex));
+	printMessage({ "Sent player choices to ", clients[clientIndex]->getUsername() });
+}
+
+Task Table::sendTsarChoice_(int clientIndex)
+{
+	co_await receivedTsarStatementCard;
+
+	co_await guarded(clientIndex, sendTsarStatementCardChoiceToClient(clientIndex));
+	printMessage({ "Sent tsar choice to ", clients[clientIndex]->getUsername() });
+}
+
+Task Table::sendConfirmation_(int clientIndex)
+{
+	co_await receivedNextRoundConfirmation;
+
+	co_await guarded(clientIndex, sendServerConfirmationToClient(clientIndex));
+}
+
+Task Table::receiveData_(int clientIndex, int round)
+{
+	if (clientIndex != game->getGameState().currentTsarIndex)
+	{
+		std::optional<Message> message;
+		co_await receiveMessage(clientIndex, MessageType::StatementCardChoice, round, message);
+		bool received = false;
+		if (message)
+		{
+			try
+			{
+				receiveStatementCardChoiceFromClient(clientIndex, *message);
+				printMessage({ "Received answer from ", clients[clientIndex]->getUsername() });
+				received = true;
+			}
+			catch (ConnectionException& exception)
+			{
+				dropClient(*clients[clientIndex], exception.what());
+			}
+			clients[clientIndex]->getInbox().recycle(std::move(*message));
+		}
+		if (!received && handleMissedDeadline(clientIndex))
+		{
+			autoPlayStatementCardChoice(clientIndex);
+		}
+		receivedStatementCardChoices.countDown();
+	}
+}
+
+Task Table::receiveTsarChoice_(int clientIndex, int round)
+{
+	// the tsar answers once it has been sent every player's choice
+	if (clientIndex == game->getGameState().currentTsarIndex)
+	{
+		if (!submissions.empty())
+		{
+			std::optional<Message> message;
+			co_await receiveMessage(clientIndex, MessageType::TsarChoice, round, message);
+			bool received = false;
+			if (message)
+			{
+				try
+				{
+					receiveStatementCardChoiceFromTsar(*message);
+					printMessage({ "Received answer from tsar. - ", clients[clientIndex]->getUsername() });
+					received = true;
+				}
+				catch (ConnectionException& exception)
+				{
+					dropClient(*clients[clientIndex], exception.what());
+				}
+				clients[clientIndex]->getInbox().recycle(std::move(*message));
+			}
+			if (!received && handleMissedDeadline(clientIndex))
+			{
+				autoPlayTsarChoice();
+			}
+		}
+		receivedTsarStatementCard.countDown();
+	}
+}
+
+Task Table::receiveConfirmation_(int clientIndex, int round)
+{
+	std::optional<Message> message;
+	co_await receiveMessage(clientIndex, MessageType::NextRoundConfirmation, round, message);
+	if (message)
+	{
+		printMessage({ "Received next round confirmation from ", clients[clientIndex]->getUsername() });
+		clients[clientIndex]->getInbox().recycle(std::move(*message));
+	}
+	else
+	{
+		handleMissedDeadline(clientIndex);
+	}
+	receivedNextRoundConfirmation.countDown();
+}
+
+SnapshotWriter& Table::newEvent()
+{
+	// events are copied into the log's buffer, so one writer serves every event
+	eventWriter.clear();
+	return eventWriter;
+}
+
+std::size_t Table::getMaxRecordBytes(int numOfInts)
+{
+	// length and type in front of the event
+	return (2 + numOfInts) * sizeof(int);
+}
+
+std::size_t Table::getMaxRecordBytesPerRound() const
+{
+	// an upper bound of what the round's events below take; falling short only costs a reallocation
+	std::size_t roundDealt = getMaxRecordBytes(3 + configuration.numOfPlayers * configuration.numOfStatementCards);
+	std::size_t cardsSubmitted = getMaxRecordBytes(4 + 2 * prompt::MAX_BLANKS);
+	std::size_t winnerChosen = getMaxRecordBytes(2);
+	return roundDealt + (configuration.numOfPlayers - 1) * cardsSubmitted + winnerChosen;
+}
+
+std::size_t Table::getMaxCheckpointBytesPerRound() const
+{
+	// the indices of the prompt and the cards drawn to refill the hands
+	return (1 + (configuration.numOfPlayers - 1) * prompt::MAX_BLANKS) * sizeof(int);
+}
+
+void Table::logGameStarted()
+{
+	SnapshotWriter& event = newEvent();
+	event.writeInt(seed);
+	event.writeInt(configuration.numOfPlayers);
+	event.writeInt(configuration.numOfRounds);
+	event.writeInt(configuration.numOfStatementCards);
+	event.writeString(deck->getPromptRepoFilepaths());
+	event.writeString(deck->getStatementCardRepoFilepaths());
+	for (auto& client : clients)
+	{
+		event.writeString(client->getUsername());
+	}
+	// lets tools tell whether the deck files they read are still the ones this game was dealt from
+	event.writeInt(deck->getVersion());
+	event.writeLongLong(deck->getFingerprint());
+	event.writeInt(deck->getPrompts()->size());
+	event.writeInt(deck->getStatementCards()->size());
+	EventLog::encode(records, EventType::GameStarted, event);
+}
+
+void Table::logRoundDealt()
+{
+	const GameState& state = game->getGameState();
+	SnapshotWriter& event = newEvent();
+	event.writeInt(currentRound);
+	event.writeInt(state.currentTsarIndex);
+	event.writeInt(state.currentPromptId);
+	for (auto& playerStatementCardIds : state.statementCardIds)
+	{
+		for (int cardId : playerStatementCardIds)
+		{
+			event.writeInt(cardId);
+		}
+	}
+	EventLog::encode(records, EventType::RoundDealt, event);
+}
+
+void Table::logCardsSubmitted(int clientIndex, const Submission& submission, bool autoPlayed)
+{
+	SnapshotWriter& event = newEvent();
+	event.writeInt(currentRound);
+	event.writeInt(clientIndex);
+	event.writeBool(autoPlayed);
+	event.writeInt(submission.numOfCards);
+	for (int i = 0; i < submission.numOfCards; i++)
+	{
+		event.writeInt(submission.handIndices[i]);
+		event.writeInt(submission.cardIds[i]);
+	}
+	EventLog::encode(records, EventType::CardsSubmitted, event);
+}
+
+void Table::logWinnerChosen()
+{
+	SnapshotWriter& event = newEvent();
+	event.writeInt(currentRound);
+	event.writeInt(roundWinnerIndex);
+	EventLog::encode(records, EventType::WinnerChosen, event);
+}
+
+void Table::logGameEnded()
+{
+	SnapshotWriter& event = newEvent();
+	for (auto& client : clients)
+	{
+		event.writeInt(client->getScore());
+	}
+	EventLog::encode(records, EventType::GameEnded, event);
+}
\ No newline at end of file
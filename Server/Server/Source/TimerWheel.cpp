@@ -0,0 +1,187 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <utility>
+
+Timer::~Timer()
+{
+	cancel();
+}
+
+void Timer::cancel()
+{
+	if (wheel)
+	{
+		wheel->cancel(*this);
+	}
+}
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution) :
+	resolution{ resolution },
+	startTime{ Clock::now() },
+	currentTick{ 0 },
+	numOfTimers{ 0 },
+	numOfNearTimers{ 0 },
+	slots(NUM_OF_LEVELS * SLOTS_PER_LEVEL, nullptr),
+	nextToVisit{ nullptr }
+{
+
+}
+
+void TimerWheel::schedule(Timer& timer, std::chrono::milliseconds delay)
+{
+	cancel(timer);
+	// measured from the clock rather than currentTick, which lags behind while the loop is busy
+	// or before it runs; rounded up so a timer never fires early, and always a tick ahead
+	long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime).count();
+	long long ticks = (elapsed + delay.count() + resolution.count() - 1) / resolution.count();
+	timer.expiryTick = std::max(ticks, currentTick + 1);
+	timer.wheel = this;
+	link(timer);
+	numOfTimers++;
+}
+
+void TimerWheel::cancel(Timer& timer)
+{
+	if (timer.wheel != this)
+	{
+		return;
+	}
+	if (nextToVisit == &timer)
+	{
+		nextToVisit = timer.next;
+	}
+	unlink(timer);
+	timer.wheel = nullptr;
+	numOfTimers--;
+}
+
+void TimerWheel::advance(Clock::time_point now)
+{
+	long long targetTick = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count() / resolution.count();
+	while (currentTick < targetTick)
+	{
+		if (numOfTimers == 0)
+		{
+			currentTick = targetTick;
+			break;
+		}
+		if (numOfNearTimers == 0)
+		{
+			// nothing on level 0, skip straight to the tick before the next cascade
+			currentTick = std::max(currentTick, std::min(targetTick, (currentTick | SLOT_MASK)));
+			if (currentTick == targetTick)
+			{
+				break;
+			}
+		}
+		currentTick++;
+		for (int level = 1; level < NUM_OF_LEVELS && currentTick % levelSpan(level) == 0; level++)
+		{
+			cascade(level);
+		}
+		expireCurrentSlot();
+	}
+}
+
+int TimerWheel::millisecondsUntilNextExpiry(Clock::time_point now) const
+{
+	if (numOfTimers == 0)
+	{
+		return -1;
+	}
+	// the next level 0 timer, or else the next cascade, which may bring one down
+	long long nextTick = (currentTick | SLOT_MASK) + 1;
+	if (numOfNearTimers > 0)
+	{
+		for (long long tick = currentTick + 1; tick < nextTick; tick++)
+		{
+			if (slots[tick & SLOT_MASK])
+			{
+				nextTick = tick;
+				break;
+			}
+		}
+	}
+	long long remaining = std::chrono::ceil<std::chrono::milliseconds>(startTime + resolution * nextTick - now).count();
+	return std::max(remaining, 0LL);
+}
+
+void TimerWheel::link(Timer& timer)
+{
+	// the distance picks the level, the expiry's digit at that level picks the slot; timers
+	// beyond the top level park in its furthest slot and are re-linked when it cascades
+	long long distance = std::max(timer.expiryTick - currentTick, 0LL);
+	int level = 0;
+	while (level < NUM_OF_LEVELS - 1 && distance >= levelSpan(level + 1))
+	{
+		level++;
+	}
+	long long tick = std::min(timer.expiryTick, currentTick + levelSpan(NUM_OF_LEVELS) - 1);
+	Timer*& head = slots[level * SLOTS_PER_LEVEL + ((tick >> (SLOT_BITS * level)) & SLOT_MASK)];
+	timer.slot = &head;
+	timer.level = level;
+	timer.previous = nullptr;
+	timer.next = head;
+	if (head)
+	{
+		head->previous = &timer;
+	}
+	head = &timer;
+	if (level == 0)
+	{
+		numOfNearTimers++;
+	}
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+	if (timer.previous)
+	{
+		timer.previous->next = timer.next;
+	}
+	else
+	{
+		*timer.slot = timer.next;
+	}
+	if (timer.next)
+	{
+		timer.next->previous = timer.previous;
+	}
+	if (timer.level == 0)
+	{
+		numOfNearTimers--;
+	}
+	timer.slot = nullptr;
+	timer.previous = nullptr;
+	timer.next = nullptr;
+}
+
+void TimerWheel::cascade(int level)
+{
+	Timer*& head = slots[level * SLOTS_PER_LEVEL + ((currentTick >> (SLOT_BITS * level)) & SLOT_MASK)];
+	Timer* timer = std::exchange(head, nullptr);
+	while (timer)
+	{
+		Timer* next = timer->next;
+		link(*timer);
+		timer = next;
+	}
+}
+
+void TimerWheel::expireCurrentSlot()
+{
+	// callbacks may cancel any timer, including the next one in this slot
+	Timer* timer = slots[currentTick & SLOT_MASK];
+	while (timer)
+	{
+		nextToVisit = timer->next;
+		cancel(*timer);
+		if (timer->callback)
+		{
+			timer->callback();
+		}
+		timer = nextToVisit;
+	}
+	nextToVisit = nullptr;
+}
\ No newline at end of file
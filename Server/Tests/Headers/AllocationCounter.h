@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+	Counts the heap allocations made through the global operator new, on every thread, for as long
+	as it lives; only one may be alive at a time. Only the test executable replaces operator new
+	for it, the server itself allocates through the library's.
+*/
+class AllocationCounter
+{
+	public:
+		AllocationCounter();
+		~AllocationCounter();
+
+		AllocationCounter(const AllocationCounter&) = delete;
+		AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+		long long getCount() const;
+};
\ No newline at end of file
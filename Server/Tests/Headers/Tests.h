@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AsyncSocket.h"
+#include "Client.h"
+#include "Interface.h"
+#include "Task.h"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+	Checks of the server's parts, built into their own executable from these sources and the
+	server's, all but its main.cpp. Every test sets up what it needs, a failed expectation is
+	printed with the test's name and the executable exits with the number of failures.
+*/
+class Tests
+{
+	public:
+		Tests();
+
+		int run();
+	private:
+		void lobbyRequeuesTooFewPlayers();
+		Task lobbyRequeuesTooFewPlayersScenario(EventLoop& loop, bool& finished);
+		void steadyRoundsDontAllocate();
+
+		// the server's reader of a player's messages, as a shard runs it
+		Task readMessages(std::shared_ptr<Client> client);
+		// the other end of a player's connection, answering every phase with the first thing it may
+		Task playAsClient(AsyncSocket& connection);
+		Task skipString(AsyncSocket& connection, std::vector<char>& text);
+
+		void expect(bool condition, const std::string& what);
+
+		Interface userInterface;
+		std::map<std::string, std::function<void()>> tests;
+		std::string currentTest;
+		int numOfFailures;
+};
\ No newline at end of file
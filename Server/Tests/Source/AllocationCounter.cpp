@@ -0,0 +1,72 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<bool> counting{ false };
+	std::atomic<long long> numOfAllocations{ 0 };
+
+	void* allocate(std::size_t size)
+	{
+		if (counting.load(std::memory_order_relaxed))
+		{
+			numOfAllocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		// malloc(0) may return null, new never does
+		if (void* memory = std::malloc(size > 0 ? size : 1))
+		{
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+}
+
+AllocationCounter::AllocationCounter()
+{
+	numOfAllocations.store(0);
+	counting.store(true);
+}
+
+AllocationCounter::~AllocationCounter()
+{
+	counting.store(false);
+}
+
+long long AllocationCounter::getCount() const
+{
+	return numOfAllocations.load();
+}
+
+// the library's nothrow forms call these, only over-aligned allocations go around them
+void* operator new(std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "Tests.h"
+#include "AllocationCounter.h"
+#include "Deck.h"
+#include "EventLoop.h"
+#include "Executor.h"
+#include "GeneratedRepository.h"
+#include "Lobby.h"
+#include "Protocol.h"
+#include "Table.h"
+
+#include <chrono>
+#include <memory>
+
+namespace
+{
+	// short enough for the test to wait out, long enough to not expire while a step runs
+	const std::chrono::milliseconds LOBBY_TIMEOUT(50);
+	// the table whose rounds are counted, the first ones fill the pools and aren't
+	const int NUM_OF_PLAYERS = 3;
+	const int NUM_OF_ROUNDS = 50;
+	const int WARMUP_ROUNDS = 3;
+	const int DECK_SIZE = 5000;
+	// the players connect to the table over loopback
+	const unsigned short PORT = 11012;
+
+	std::shared_ptr<Client> makePlayer(const std::string& username)
+	{
+		auto player = std::make_shared<Client>();
+		player->setUsername(username);
+		return player;
+	}
+}
+
+Tests::Tests() :
+	numOfFailures{ 0 }
+{
+	tests["lobby requeues too few players"] = [this]{ lobbyRequeuesTooFewPlayers(); };
+	tests["steady rounds don't allocate"] = [this]{ steadyRoundsDontAllocate(); };
+}
+
+int Tests::run()
+{
+	for (auto& [name, test] : tests)
+	{
+		currentTest = name;
+		test();
+	}
+	userInterface.printMessage(std::to_string(tests.size()) + " tests, " + std::to_string(numOfFailures) + " failed expectations");
+	return numOfFailures;
+}
+
+void Tests::lobbyRequeuesTooFewPlayers()
+{
+	EventLoop loop;
+	bool finished = false;
+	loop.spawn(lobbyRequeuesTooFewPlayersScenario(loop, finished));
+	loop.run();
+	expect(finished, "the scenario ran to its end");
+}
+
+Task Tests::lobbyRequeuesTooFewPlayersScenario(EventLoop& loop, bool& finished)
+{
+	Lobby lobby(loop, 4, 2, LOBBY_TIMEOUT);
+	int numOfTablesFormed = 0;
+	Lobby::Players expired;
+	lobby.onTableFormed = [&numOfTablesFormed](Lobby::Players){ numOfTablesFormed++; };
+	lobby.onExpired = [&expired](Lobby::Players players){ expired = std::move(players); };
+	lobby.open();
+	auto first = makePlayer("first");
+	auto second = makePlayer("second");
+	lobby.join(first);
+	lobby.join(second);
+
+	// the timeout seats both at a partial table of the minimum size, which waits for latecomers
+	co_await loop.sleep(2 * LOBBY_TIMEOUT);
+	expect(lobby.contains(*first) && lobby.contains(*second), "both wait at a partial table");
+	expect(expired.empty(), "nobody was sent home at the minimum size");
+
+	// one leaves before the fill timeout, the other can't play alone and queues again
+	expect(lobby.leave(*first), "the first player left");
+	expect(lobby.contains(*second), "the second player still waits");
+	expect(numOfTablesFormed == 0, "no table was formed for a single player");
+
+	// alone in the queue, the second player's new timeout sends them home
+	co_await loop.sleep(2 * LOBBY_TIMEOUT);
+	expect(numOfTablesFormed == 0, "no table was formed when the timeout ran out");
+	expect(expired.size() == 1 && expired.front() == second, "the second player expired");
+	expect(lobby.isEmpty(), "the lobby is empty");
+	finished = true;
+}
+
+void Tests::steadyRoundsDontAllocate()
+{
+	auto deck = std::make_shared<const Deck>(1, std::make_shared<GeneratedRepository<Prompt>>(DECK_SIZE),
+		std::make_shared<GeneratedRepository<StatementCard>>(DECK_SIZE));
+	TableSettings settings{ GameConfiguration(NUM_OF_PLAYERS, NUM_OF_ROUNDS, 7), std::chrono::seconds(60), TimeoutPolicy::AutoPlay, true };
+	Executor executor;
+	EventLoop loop;
+	Socket listening(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	listening.Bind(IPv4Address("127.0.0.1", PORT));
+	listening.Listen();
+	Table table(loop, executor, userInterface, 1, settings, deck);
+	Table::Players players;
+	std::vector<Socket> peers;
+	std::vector<std::unique_ptr<AsyncSocket>> peerConnections;
+	for (int i = 0; i < NUM_OF_PLAYERS; i++)
+	{
+		peers.emplace_back(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		peers.back().Connect(IPv4Address("127.0.0.1", PORT));
+		peerConnections.emplace_back(std::make_unique<AsyncSocket>(loop, peers.back().GetHandle()));
+		auto player = std::make_shared<Client>();
+		player->setUsername("Player " + std::to_string(i));
+		listening.Accept(player->getSocket(), player->getAddress());
+		player->setConnection(std::make_unique<AsyncSocket>(loop, player->getSocket().GetHandle()));
+		players.emplace_back(std::move(player));
+	}
+	listening.Close();
+	for (int i = 0; i < NUM_OF_PLAYERS; i++)
+	{
+		loop.spawn(readMessages(players[i]));
+		loop.spawn(playAsClient(*peerConnections[i]));
+	}
+	table.seat(std::move(players), 1);
+	// taken when each round is over, the round's checkpoint included
+	std::vector<long long> counts;
+	counts.reserve(NUM_OF_ROUNDS);
+	table.onGameEnded = [](Table&){ };
+	table.onIdle = [](Table&){ };
+	AllocationCounter counter;
+	table.onRoundEnded = [&counts, &counter](Table&){ counts.emplace_back(counter.getCount()); };
+	table.start();
+	loop.run();
+
+	// every round but the last one ends with a checkpoint
+	expect(counts.size() == NUM_OF_ROUNDS - 1, "a round end for every round but the last, got " + std::to_string(counts.size()));
+	if (counts.size() > WARMUP_ROUNDS)
+	{
+		long long steady = counts.back() - counts[WARMUP_ROUNDS - 1];
+		expect(steady == 0, "no allocations after " + std::to_string(WARMUP_ROUNDS) + " rounds, got " + std::to_string(steady) +
+			" in " + std::to_string(counts.size() - WARMUP_ROUNDS) + " rounds");
+	}
+}
+
+Task Tests::readMessages(std::shared_ptr<Client> client)
+{
+	AsyncSocket& connection = client->getConnection();
+	try
+	{
+		while (true)
+		{
+			MessageHeader header;
+			co_await connection.receive(&header, sizeof(MessageHeader));
+			Message message;
+			message.type = static_cast<MessageType>(header.type);
+			message.round = header.round;
+			message.payload = client->getInbox().takeBuffer();
+			message.payload.resize(header.length);
+			if (header.length > 0)
+			{
+				co_await connection.receive(message.payload.data(), header.length);
+			}
+			client->getInbox().push(std::move(message));
+		}
+	}
+	catch (ConnectionException&)
+	{
+		// the table disconnects its players when the game is over
+	}
+}
+
+Task Tests::playAsClient(AsyncSocket& connection)
+{
+	// card and player texts are read into the same buffer and never looked at
+	std::vector<char> text(protocol::MAX_MESSAGE_LENGTH);
+	std::vector<int> cardIds(prompt::MAX_BLANKS);
+	try
+	{
+		int playerIndex;
+		int numOfPlayers;
+		int numOfRounds;
+		int numOfStatementCards;
+		co_await connection.receive(&playerIndex, sizeof(int));
+		co_await connection.receive(&numOfPlayers, sizeof(int));
+		for (int i = 0; i < numOfPlayers; i++)
+		{
+			co_await skipString(connection, text);
+		}
+		co_await connection.receive(&numOfRounds, sizeof(int));
+		co_await connection.receive(&numOfStatementCards, sizeof(int));
+		for (int round = 0; round < numOfRounds; round++)
+		{
+			int tsarIndex;
+			int numOfBlanks;
+			co_await connection.receive(&tsarIndex, sizeof(int));
+			co_await skipString(connection, text);
+			co_await connection.receive(&numOfBlanks, sizeof(int));
+			if (playerIndex != tsarIndex)
+			{
+				// plays the first cards of the hand
+				int numOfCards;
+				co_await connection.receive(&numOfCards, sizeof(int));
+				for (int i = 0; i < numOfCards; i++)
+				{
+					int cardId;
+					co_await connection.receive(&cardId, sizeof(int));
+					co_await skipString(connection, text);
+					if (i < numOfBlanks)
+					{
+						cardIds[i] = cardId;
+					}
+				}
+				MessageHeader header{ static_cast<int>(MessageType::StatementCardChoice), round, static_cast<int>(numOfBlanks * sizeof(int)) };
+				co_await connection.send(&header, sizeof(MessageHeader));
+				co_await connection.send(cardIds.data(), header.length);
+			}
+			int numOfChoices;
+			co_await connection.receive(&numOfChoices, sizeof(int));
+			for (int i = 0; i < numOfChoices; i++)
+			{
+				int numOfCards;
+				co_await connection.receive(&numOfCards, sizeof(int));
+				for (int j = 0; j < numOfCards; j++)
+				{
+					co_await skipString(connection, text);
+				}
+			}
+			if (playerIndex == tsarIndex)
+			{
+				int choiceIndex = 0;
+				MessageHeader header{ static_cast<int>(MessageType::TsarChoice), round, sizeof(int) };
+				co_await connection.send(&header, sizeof(MessageHeader));
+				co_await connection.send(&choiceIndex, sizeof(int));
+			}
+			int winnerIndex;
+			int chosenIndex;
+			co_await connection.receive(&winnerIndex, sizeof(int));
+			co_await connection.receive(&chosenIndex, sizeof(int));
+			MessageHeader confirmation{ static_cast<int>(MessageType::NextRoundConfirmation), round, 0 };
+			co_await connection.send(&confirmation, sizeof(MessageHeader));
+			bool serverConfirmation;
+			co_await connection.receive(&serverConfirmation, sizeof(bool));
+		}
+	}
+	catch (ConnectionException& exception)
+	{
+		expect(false, "the game to be played out, the connection failed: " + std::string(exception.what()));
+	}
+	connection.close();
+}
+
+Task Tests::skipString(AsyncSocket& connection, std::vector<char>& text)
+{
+	int length;
+	co_await connection.receive(&length, sizeof(int));
+	if (length < 0 || length > text.size())
+	{
+		throw ConnectionException("Malformed string.");
+	}
+	co_await connection.receive(text.data(), length);
+}
+
+void Tests::expect(bool condition, const std::string& what)
+{
+	if (!condition)
+	{
+		numOfFailures++;
+		userInterface.printMessage(currentTest + ": expected " + what);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#include "Tests.h"
+
+int main()
+{
+	return Tests().run();
+}
\ No newline at end of file